@@ -15,6 +15,13 @@ evaluations and algorithmic trends.
 #include <iostream>
 #include <chrono>
 #include <vector>
+#include <thread>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <limits>
+#include <stdexcept>
 
 using namespace std;
 
@@ -38,7 +45,12 @@ ALNS::ALNS(ALNSData &data_obj, // We want a normal object interface to easily ex
 	double random_noise,
 	double target_inf,
 	double shakeup_log,
-	double mean_removal_log) :
+	double mean_removal_log,
+	int num_threads,
+	int migration_interval,
+	bool share_potential_matrix,
+	int seed,
+	bool log_full_solutions) :
 	max_time(max_time),
 	max_iterations(max_iterations),
 	init_temperature(init_temperature),
@@ -55,9 +67,13 @@ ALNS::ALNS(ALNSData &data_obj, // We want a normal object interface to easily ex
 	target_inf(target_inf),
 	mean_removal_log(mean_removal_log),
 	shakeup_log(shakeup_log),
+	num_threads(num_threads),
+	migration_interval(migration_interval),
+	share_potential_matrix(share_potential_matrix),
+	log_full_solutions(log_full_solutions),
+	random_generator(seed >= 0 ? uint32_t(seed) : std::random_device{}()), // negative seed -> random
 	data_obj(data_obj),
-	node_pair_potential_matrix(data_obj.nr_nodes, vector<double>(data_obj.nr_nodes, std::numeric_limits<double>::max())),
-	node_pair_useage_matrix(data_obj.nr_nodes, vector<int>(data_obj.nr_nodes, 0)),
+	historic_matrices(data_obj.nr_nodes),
 	current_solution(data_obj), // We use reference wrapper for each solution object -> no null state -> need to initialize
 	running_solution(data_obj),
 	solution(data_obj)// This is the null state! (no valid solution object)
@@ -67,438 +83,728 @@ ALNS::ALNS(ALNSData &data_obj, // We want a normal object interface to easily ex
 	this->frame_error_weight = 1;
 	this->mean_removal = log(this->data_obj.nr_customer) / log(mean_removal_log);
 
-	// Set the min additional pseudo capacity to guarantee a solution with random initialization
-	this->operator_names_d = destroy_operator_names;
-	this->operator_names_r = repair_operator_names;
-
-	vector<function<vector<int>()>> destroy_functors = this->get_destroy_functors();
-
-	this->destroy_wheel = DestroyRouletteWheel(destroy_functors,
+	// Create the operators (owned by the registry, bound to the running solution)
+	OperatorContext context = {
+		this->running_solution,
+		this->random_generator,
+		this->operator_scratch,
+		this->capa_error_weight,
+		this->frame_error_weight,
+		this->mean_removal,
+		this->random_noise,
+		this->data_obj,
+		this->historic_matrices };
+
+	this->operator_registry = OperatorRegistry(context, destroy_operator_names, repair_operator_names);
+	this->operator_names_d = this->operator_registry.get_destroy_names();
+	this->operator_names_r = this->operator_registry.get_repair_names();
+
+	this->destroy_wheel = DestroyRouletteWheel(
+		this->operator_registry.nr_destroy_operators(),
 		wheel_parameter,
 		this->operator_names_d.size()*wheel_memory_length,
 		functor_min_weight);
 
-	vector<function<void(vector<int>)>> insertion_functors = this->get_insertion_functors();
-
 	this->insertion_wheel = InsertionRouletteWheel(
-		insertion_functors,
+		this->operator_registry.nr_repair_operators(),
 		wheel_parameter,
 		this->operator_names_r.size()*wheel_memory_length,
 		functor_min_weight);
+
+	this->stats = SearchStats(this->operator_names_d.size(), this->operator_names_r.size());
 }
 
 /**
-	Utility function to generate all destroy_functors based on the given config.
-	This allows a comprehensive computational experiment with varriing operators!
+Utility functions to keep all historic informations
+up to date.
+Relevant for some operators!
+*/
+void ALNS::update_historic_matrices() {
+	// Only the edges of the changed routes are touched (see historic_matrices.h)
+	this->historic_matrices.update(this->running_solution);
+}
 
-	Annotation:
-	Mostly used as initialization input for the roulette wheel mechanism
+/**
+Utility function to update infeasibiliy weights as demanded
 */
-vector < function<vector<int>()>> ALNS::get_destroy_functors() {
-	// No functors are passed, use random destroy as default
-	if (this->operator_names_d.size() == 0) {
+void ALNS::update_weights() {
+	double current_inf = this->inf_count / 100;
 
-		cout << "No destroy operator supplied, take random_destroy as default" << endl;
-		this->operator_names_d.push_back(string("random_destroy"));
+	// case 1: Not enough infeasibility
+	if ((current_inf + 0.05) < this->target_inf) {
+		this->capa_error_weight *= 0.85;
+		this->frame_error_weight *= 0.85;
+	} // case 2: too much infeasibility
+	else if ((current_inf - 0.05) > this->target_inf) {
+		this->frame_error_weight *= 1.2;
+		this->capa_error_weight *= 1.2;
 	}
 
-	vector<function<vector<int>()>> destroy_functors;
-	for (string operator_name : this->operator_names_d) {
-		if (operator_name == "random_destroy") {
-			RandomDestroyOperator* op = new RandomDestroyOperator(
-				this->running_solution,
-				this->capa_error_weight,
-				this->frame_error_weight,
-				this->mean_removal);
+	// Reevaluate all solutions with ne weights
+	// (No best solution -> only feasible solutions possibel in there)
+	this->current_solution.set_quality(this->capa_error_weight, this->frame_error_weight);
+	this->running_solution.set_quality(this->capa_error_weight, this->frame_error_weight);
+}
 
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "route_destroy") {
-			RandomRouteDestroyOperator* op = new RandomRouteDestroyOperator(
-				this->running_solution,
-				this->capa_error_weight,
-				this->frame_error_weight);
+/**
+Main function for the ALNS algorithm
+Uses all standard input parameter provided in the interface
 
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "demand_destroy") {
-			BiggestDemandDestroyOperator* op = new BiggestDemandDestroyOperator(
-				this->running_solution,
-				this->data_obj.demand,
-				this->random_noise,
-				this->capa_error_weight,
-				this->frame_error_weight,
-				this->mean_removal);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "time_destroy") {
-			WorstTravelTimeDestroyOperator* op = new WorstTravelTimeDestroyOperator(
-				this->running_solution,
-				this->random_noise,
-				this->capa_error_weight,
-				this->frame_error_weight,
-				this->mean_removal);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "worst_destroy") {
-			WorstRemovalDestroyOperator* op = new WorstRemovalDestroyOperator(
-				this->running_solution,
-				this->random_noise,
-				this->capa_error_weight,
-				this->frame_error_weight,
-				this->mean_removal);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "node_pair_destroy") {
-			NodePairDestroyOperator* op = new NodePairDestroyOperator(
-				this->running_solution,
-				this->node_pair_potential_matrix,
-				this->random_noise,
-				this->capa_error_weight,
-				this->frame_error_weight,
-				this->mean_removal);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "shaw_destroy") {
-			ShawDestroyOperator* op = new ShawDestroyOperator(
-				this->running_solution,
-				9, // distance weight
-				3, // window weight
-				2, // demadn weight
-				5, // veh weight
-				this->data_obj.norm_distance_matrix,
-				this->data_obj.norm_start_window_matrix,
-				this->data_obj.norm_end_window_matrix,
-				this->data_obj.norm_demand_matrix,
-				this->random_noise,
-				this->mean_removal,
-				this->capa_error_weight,
-				this->frame_error_weight);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "distance_similarity") {
-			ShawDestroyOperator* op = new ShawDestroyOperator(
-				this->running_solution,
-				1, // distance weight
-				0, // window weight
-				0, // demadn weight
-				0, // veh weight
-				this->data_obj.norm_distance_matrix,
-				this->data_obj.norm_start_window_matrix,
-				this->data_obj.norm_end_window_matrix,
-				this->data_obj.norm_demand_matrix,
-				this->random_noise,
-				this->mean_removal,
-				this->capa_error_weight,
-				this->frame_error_weight);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "window_similarity") {
-			ShawDestroyOperator* op = new ShawDestroyOperator(
-				this->running_solution,
-				0, // distance weight
-				1, // window weight
-				0, // demand weight
-				0, // veh weight
-				this->data_obj.norm_distance_matrix,
-				this->data_obj.norm_start_window_matrix,
-				this->data_obj.norm_end_window_matrix,
-				this->data_obj.norm_demand_matrix,
-				this->random_noise,
-				this->mean_removal,
-				this->capa_error_weight,
-				this->frame_error_weight);
-
-			destroy_functors.push_back(*op);
-		}
-		else if (operator_name == "demand_similarity") {
-		ShawDestroyOperator* op = new ShawDestroyOperator(
-			this->running_solution,
-			0, // distance weight
-			0, // window weight
-			1, // demand weight
-			0, // veh weight
-			this->data_obj.norm_distance_matrix,
-			this->data_obj.norm_start_window_matrix,
-			this->data_obj.norm_end_window_matrix,
-			this->data_obj.norm_demand_matrix,
-			this->random_noise,
-			this->mean_removal,
-			this->capa_error_weight,
-			this->frame_error_weight);
+The search runs until max_time / max_iterations (without improvement) or cancel
+*/
+Solution ALNS::solve() {
+	// 0) Multiple threads -> island model (the islands run this function themselves)
+	if ((this->num_threads > 1) && (this->migration_pool == nullptr)) {
+		return this->solve_parallel();
+	}
+
+	// 1) Initialization
+	this->start_search();
+
+	// 2) - 5) Search
+	this->run_search(-1);
 
-		destroy_functors.push_back(*op);
+	cout << "INFO:c++: solving (DONE)" << endl;
+	return this->solution;
+}
+
+/**
+Warm start: Solve from the given routes or solution
+(kept for all following searches, see set_initial_solution)
+*/
+Solution ALNS::solve(const vector<vector<int>> &initial_routes) {
+	this->set_initial_solution(initial_routes);
+	return this->solve();
+}
+
+Solution ALNS::solve(const Solution &initial_solution) {
+	return this->solve(initial_solution.solution_representation);
+}
+
+/**
+Set the routes the following searches start from
+
+@param initial_routes:	One route per vehicle (customer ids), customers may be missing
+						(inserted at the start of the search). Empty: random initialization
+*/
+void ALNS::set_initial_solution(const vector<vector<int>> &initial_routes) {
+	if (!initial_routes.empty()) {
+		if (int(initial_routes.size()) != this->data_obj.nr_vehicles) {
+			throw invalid_argument("The initial solution must have one route per vehicle");
 		}
-		else {
-			throw invalid_argument("At least one of the provided destroy operators unknown");
+
+		vector<bool> is_planned(this->data_obj.nr_customer, false);
+		for (const vector<int> &route : initial_routes) {
+			for (int customer_id : route) {
+				if ((customer_id < 0) || (customer_id >= this->data_obj.nr_customer) || is_planned[customer_id]) {
+					throw invalid_argument("Invalid initial solution: unknown or repeated customer " + to_string(customer_id));
+				}
+				is_planned[customer_id] = true;
+			}
 		}
 	}
+	this->initial_routes = initial_routes;
+}
+
+/**
+Set the construction heuristic of the initial solution (see construction.h)
 
-	return destroy_functors;
+@param heuristic:	"random", "savings", "solomon_i1" or "sweep"
+@param nr_seeds:	Number of trials (trial 0 is the plain heuristic, the others are randomized)
+*/
+void ALNS::set_construction_heuristic(const string &heuristic, int nr_seeds) {
+	if (nr_seeds < 1) {
+		throw invalid_argument("The construction heuristic needs at least one seed");
+	}
+	this->construction_heuristic = construction::get_heuristic(heuristic);
+	this->nr_construction_seeds = nr_seeds;
 }
 
 /**
-	Utility function to generate all destroy_functors based on the given config.
-	This allows a comprehensive computational experiment with varriing operators!
+Enable (capacity > 0) or disable (capacity 0) the progress log (see progress_ring.h)
 
-	Annotation:
-	Mostly used as initialization input for the roulette wheel mechanism
+@param capacity:	Number of records in the ring (rounded up to a power of 2), a full ring drops records
+@param interval:	Record every [interval] iterations in addition to the improvements (0: improvements only)
 */
-vector<function<void(vector<int>)>> ALNS::get_insertion_functors() {
-	// No operator supplied, pass greedy as default
-	if (this->operator_names_r.size() == 0) {
-		cout << "No insertion operator supplied, take basic_greedy as default" << endl;
-		this->operator_names_r.push_back(string("basic_greedy"));
+void ALNS::set_progress_log(int capacity, int interval) {
+	if ((capacity < 0) || (interval < 0)) {
+		throw invalid_argument("The capacity and interval of the progress log must not be negative");
 	}
+	this->progress_ring = (capacity > 0) ? make_shared<ProgressRing>(size_t(capacity)) : nullptr;
+	this->progress_interval = interval;
+}
 
-	vector<function<void(vector<int>)>> repair_functors;
+/**
+Take the oldest records of the progress log (negative max_records: all, thread safe)
+*/
+vector<ProgressRecord> ALNS::drain_progress(int64_t max_records) {
+	vector<ProgressRecord> records;
+	shared_ptr<ProgressRing> ring = this->progress_ring;
 
-	for (string operator_name : this->operator_names_r) {
-		if (operator_name == "basic_greedy") {
-			BasicGreedyInsertionOperator* op = new BasicGreedyInsertionOperator(this->running_solution, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else if (operator_name == "random_greedy") {
-			RandomGreedyInsertionOperator* op = new RandomGreedyInsertionOperator(this->running_solution, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else if (operator_name == "deep_greedy") {
-			DeepGreedyInsertionOperator *op = new DeepGreedyInsertionOperator(this->running_solution, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else if (operator_name == "2_regret") {
-			KRegretInsertionOperator *op = new KRegretInsertionOperator(this->running_solution, 2, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else if (operator_name == "3_regret") {
-			KRegretInsertionOperator *op = new KRegretInsertionOperator(this->running_solution, 3, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else if (operator_name == "5_regret") {
-			KRegretInsertionOperator *op = new KRegretInsertionOperator(this->running_solution, 5, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else if (operator_name == "beta_hybrid") {
-			BetaHybridInsertionOperator* op = new BetaHybridInsertionOperator(this->running_solution, 3, this->capa_error_weight, this->frame_error_weight);
-			repair_functors.push_back(*op);
-		}
-		else {
-			throw invalid_argument("At least one of the provided insertion operators unknown");
+	if (ring) {
+		ring->drain(records, max_records);
+	}
+	return records;
+}
+
+int64_t ALNS::get_nr_dropped_progress() const {
+	return this->progress_ring ? this->progress_ring->get_nr_dropped() : 0;
+}
+
+/**
+Get the learned state of this object (see SearchMemory)
+*/
+SearchMemory ALNS::get_search_memory() const {
+	SearchMemory memory;
+	memory.destroy_operators = this->operator_names_d;
+	memory.destroy_weights = this->destroy_wheel.weights;
+	memory.repair_operators = this->operator_names_r;
+	memory.repair_weights = this->insertion_wheel.weights;
+
+	memory.nr_nodes = this->data_obj.nr_nodes;
+	memory.node_pair_potential_matrix = this->historic_matrices.get_potential_matrix();
+	memory.node_pair_usage_matrix = this->historic_matrices.get_usage_matrix();
+	return memory;
+}
+
+/**
+Utility function to get the weights of the operators by name
+(operators that are not part of the memory get the mean weight of the memory)
+*/
+vector<double> get_carried_weights(const vector<string> &operator_names,
+	const vector<double> &current_weights,
+	const vector<string> &memory_names,
+	const vector<double> &memory_weights)
+{
+	if (memory_names.size() != memory_weights.size()) {
+		throw invalid_argument("The search memory needs one weight per operator");
+	}
+	if (memory_weights.empty()) {
+		return current_weights;
+	}
+
+	double mean_weight = 0;
+	for (double weight : memory_weights) {
+		mean_weight += weight / memory_weights.size();
+	}
+
+	vector<double> weights(operator_names.size(), mean_weight);
+	for (unsigned int operator_id = 0; operator_id < operator_names.size(); operator_id++) {
+		vector<string>::const_iterator it = find(memory_names.begin(), memory_names.end(), operator_names[operator_id]);
+		if (it != memory_names.end()) {
+			weights[operator_id] = memory_weights[it - memory_names.begin()];
 		}
 	}
-	return repair_functors;
+	return weights;
 }
 
 /**
-Utility functions to keep all historic informations
-up to date.
-Relevant for some operators!
+Seed the wheels and historic matrices with the memory of another search
+
+The memory is kept (in the node ids of this object) and is also passed to the islands of a parallel solve.
+
+@param memory:		State of another search (see get_search_memory)
+@param node_map:	Node id of the memory -> node id of this data object (-1: dropped)
+					Empty: identity for all nodes of both instances
 */
-void ALNS::update_historic_matrices() {
-	for (vector<int> &route : this->running_solution.solution_representation) {
+void ALNS::set_search_memory(const SearchMemory &memory, const vector<int> &node_map) {
+	int nr_nodes = this->data_obj.nr_nodes;
+	size_t nr_memory_pairs = size_t(memory.nr_nodes)*memory.nr_nodes;
 
-		// start with depot
-		int prev_node_id = 0;
-		if (route.size() > 0) {
-			for (int customer_id : route) {
-				// log best positional capabilities of position
-				if (this->node_pair_potential_matrix[prev_node_id][customer_id + 1] > this->running_solution.driving_time) {
-					this->node_pair_potential_matrix[prev_node_id][customer_id + 1] = this->running_solution.driving_time;
-				}
+	if ((!memory.node_pair_potential_matrix.empty() && memory.node_pair_potential_matrix.size() != nr_memory_pairs)
+		|| (!memory.node_pair_usage_matrix.empty() && memory.node_pair_usage_matrix.size() != nr_memory_pairs)) {
+		throw invalid_argument("The node pair matrices of the search memory must be of dimension nr_nodes x nr_nodes");
+	}
+	if (!node_map.empty() && int(node_map.size()) != memory.nr_nodes) {
+		throw invalid_argument("The node map must have one entry per node of the search memory");
+	}
+
+	// 1) Map the nodes of the memory to the nodes of this data object
+	SearchMemory mapped;
+	mapped.destroy_operators = this->operator_names_d;
+	mapped.destroy_weights = get_carried_weights(this->operator_names_d, this->destroy_wheel.weights, memory.destroy_operators, memory.destroy_weights);
+	mapped.repair_operators = this->operator_names_r;
+	mapped.repair_weights = get_carried_weights(this->operator_names_r, this->insertion_wheel.weights, memory.repair_operators, memory.repair_weights);
+	mapped.nr_nodes = nr_nodes;
+
+	vector<int> new_node_ids(memory.nr_nodes, -1);
+	for (int node_id = 0; node_id < memory.nr_nodes; node_id++) {
+		int new_node_id = node_map.empty() ? node_id : node_map[node_id];
+		if ((new_node_id < nr_nodes) && (new_node_id >= 0)) {
+			new_node_ids[node_id] = new_node_id;
+		}
+	}
 
-				// log useage matrix of solutions
-				this->node_pair_useage_matrix[prev_node_id][customer_id + 1]++;
-				prev_node_id = customer_id + 1;
+	if (!memory.node_pair_potential_matrix.empty()) {
+		mapped.node_pair_potential_matrix.assign(size_t(nr_nodes)*nr_nodes, numeric_limits<float>::max());
+	}
+	if (!memory.node_pair_usage_matrix.empty()) {
+		mapped.node_pair_usage_matrix.assign(size_t(nr_nodes)*nr_nodes, 0);
+	}
+
+	for (int from = 0; from < memory.nr_nodes; from++) {
+		for (int to = 0; (to < memory.nr_nodes) && (new_node_ids[from] >= 0); to++) {
+			if (new_node_ids[to] < 0) {
+				continue;
 			}
 
-			// last node -> depot
-			this->node_pair_potential_matrix[prev_node_id][0] = this->running_solution.driving_time;
-			this->node_pair_useage_matrix[prev_node_id][0]++;
+			size_t index = size_t(from)*memory.nr_nodes + to;
+			size_t new_index = size_t(new_node_ids[from])*nr_nodes + new_node_ids[to];
+			if (!memory.node_pair_potential_matrix.empty()) {
+				mapped.node_pair_potential_matrix[new_index] = memory.node_pair_potential_matrix[index];
+			}
+			if (!memory.node_pair_usage_matrix.empty()) {
+				mapped.node_pair_usage_matrix[new_index] = memory.node_pair_usage_matrix[index];
+			}
 		}
 	}
+
+	// 2) Seed this object
+	this->destroy_wheel.set_weights(mapped.destroy_weights);
+	this->insertion_wheel.set_weights(mapped.repair_weights);
+	this->historic_matrices.set_prior(mapped.node_pair_potential_matrix, mapped.node_pair_usage_matrix);
+
+	this->search_memory = mapped;
+	this->has_search_memory = true;
 }
 
 /**
-Utility function to update infeasibiliy weights as demanded
+Time sliced search: Runs the search for about time_ms and returns the best solution so far
+The search state (solutions, temperature, iteration counters, wheels) is kept between calls.
+A new search is started with the first call (or after reset_search).
+
+Annotation:
+	A finished (or cancelled) search returns immediately -> check is_search_finished
+	Only supported for a single thread (the islands are not kept between calls)
+
+@param time_ms:		Max runtime of this call (the last iteration is always completed)
 */
-void ALNS::update_weights() {
-	double current_inf = this->inf_count / 100;
+Solution ALNS::solve_for(int time_ms) {
+	if (this->num_threads > 1) {
+		throw runtime_error("solve_for is only supported for num_threads = 1 (use solve)");
+	}
 
-	// case 1: Not enough infeasibility
-	if ((current_inf + 0.05) < this->target_inf) {
-		this->capa_error_weight *= 0.85;
-		this->frame_error_weight *= 0.85;
-	} // case 2: too much infeasibility
-	else if ((current_inf - 0.05) > this->target_inf) {
-		this->frame_error_weight *= 1.2;
-		this->capa_error_weight *= 1.2;
+	if (!this->search_started) {
+		this->start_search();
 	}
 
-	// Reevaluate all solutions with ne weights
-	// (No best solution -> only feasible solutions possibel in there)
-	this->current_solution.set_quality(this->capa_error_weight, this->frame_error_weight);
-	this->running_solution.set_quality(this->capa_error_weight, this->frame_error_weight);
+	if (!this->search_finished) {
+		this->run_search(max(time_ms, 0));
+	}
+	return this->solution;
+}
+
+void ALNS::reset_search() {
+	this->search_started = false;
+	this->search_finished = false;
+	this->cancel_requested = false;
+}
+
+bool ALNS::is_cancelled() const {
+	return this->cancel_requested || ((this->migration_pool != nullptr) && this->migration_pool->cancel_requested);
 }
 
 /**
-Main function for the ALNS algorithm
-Uses all standard input parameter provided in the interface
+Initialization of a new search
 */
-Solution ALNS::solve() {
-	// 1) Initialization
+void ALNS::start_search() {
 	// 1.0) The operators and wheels have been initialized in the constructor
 	// 1.1) Initialization of running solution, current, best solution (S_i, S_c, S_b)
 	this->initialization();
 
 	// 1.2) Set initial temperature (based on solution quality)
-	double current_temperature = this->init_temperature*this->running_solution.solution_quality; // implicitly depending on the number of customers
+	this->current_temperature = this->init_temperature*this->running_solution.solution_quality; // implicitly depending on the number of customers
 
 	// 1.3) Set current start point and iteration tracking
-	int iteration = 0;
-	int iteration_wi = 0; // nr iterations without improvement
-	int iteration_inf = 0; // current infeasibility pointer for vector
-	__int64 start = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count(); // start time
-	
-	// 1.4) Use prev time stamp for current state tracking
-	__int64 prev_time_stamp = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
-
-	while (((prev_time_stamp - start) / 1000 < this->max_time) && (iteration_wi < this->max_iterations)) {
-		// 2) Select operators (based on current weights)
-		function<vector<int>()> &destroy_operator = this->destroy_wheel.get_random_operator();
-		function<void(vector<int>)> &insertion_operator = this->insertion_wheel.get_random_operator();
-
-		// 3) Apply destroy and insertion operators
-		// 3.1) Perform operation
-		// We do not discriminate insertion / destroy to avoid overfitting
-		__int64 time_stamp = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
-		vector<int> removed_customers = destroy_operator();
-		insertion_operator(removed_customers);
-
-		// 3.2) Log solution for historic evaluation
-		update_historic_matrices();
-
-		// 4) Process solution and evaluate it against other solutions
-		double operation_benefit = 0;
-
-		// 4.1) Identify if we already visited the solution (if so -> ignore best comparison)
-		// DEP: More info but more mem size_t count_sol = this->visited_solutions.count(this->running_solution);
-		size_t count_sol = this->visited_solutions.count(this->running_solution.solution_representation);
-
-		// (if the previous solution is not visited count(0)->save it)
-		if (!count_sol) {
-			operation_benefit += this->functor_reward_unique;
+	this->iteration = 0;
+	this->iteration_wi = 0;
+	this->iteration_inf = 0;
+	this->search_time_ms = 0;
+	this->stats = SearchStats(this->operator_names_d.size(), this->operator_names_r.size());
+
+	this->search_started = true;
+	this->search_finished = false;
+}
+
+/**
+Run iterations until the search is finished or the time slice is used
+
+@param max_slice_ms:	Max runtime of the slice (< 0 -> no limit)
+*/
+void ALNS::run_search(int64_t max_slice_ms) {
+	// Use prev time stamp for current state tracking
+	int64_t slice_start = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	int64_t prev_time_stamp = slice_start;
+	int64_t prev_search_time_ms = this->search_time_ms;
+	int slice_iterations = 0;
+
+	while (true) {
+		int64_t search_time_ms = prev_search_time_ms + prev_time_stamp - slice_start;
+
+		if ((search_time_ms / 1000 >= this->max_time) || (this->iteration_wi >= this->max_iterations) || this->is_cancelled()) {
+			this->search_finished = true;
+
+			// the cancel is used up by this search (the islands are cleared by solve_parallel)
+			if (this->migration_pool == nullptr) {
+				this->cancel_requested = false;
+			}
+			break;
+		}
+		// (at least one iteration per slice -> progress for any slice length)
+		if ((max_slice_ms >= 0) && (slice_iterations > 0)) {
+			int64_t time_stamp = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+			if (time_stamp - slice_start >= max_slice_ms) {
+				break;
+			}
 		}
 
-		// 4.2) Compare running solution with current solution
-		double running_quality = this->running_solution.solution_quality;
-		double current_quality = this->current_solution.solution_quality;
+		prev_time_stamp = this->iterate();
+		slice_iterations++;
+	}
 
+	// Report the final KPIs without service times (standard reporting)
+	int64_t slice_end = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	this->search_time_ms = prev_search_time_ms + slice_end - slice_start;
 
-		if (running_quality < current_quality) {
-			// Always accept strictly better solutions
-			this->current_solution = this->running_solution;
-			operation_benefit += this->functor_reward_accept_better;
-		}
-		else {
-			double diversity_relevance = exp(-(running_quality - current_quality) / current_temperature);
+	this->iterations = this->iteration;
+	this->solution_time_ms = int(this->search_time_ms);
+	this->value = this->solution.driving_time;
+}
 
-			double diversity = this->running_solution.get_diversity(this->node_pair_useage_matrix, iteration);
-			operation_benefit += diversity * diversity_relevance * this->functor_reward_divers;
+/**
+One iteration of the search (destroy, repair, acceptance, adaption)
 
-			// Not better than current -> cannot be better than global best
-			// (except in edge cases) because time != quality
-			operation_benefit += this->functor_penalty;
+@return:	Start time stamp of the iteration
+*/
+int64_t ALNS::iterate() {
+	StatsClock::time_point iteration_start = StatsClock::now();
+
+	// 2) Select operators (based on current weights)
+	int destroy_id = this->destroy_wheel.get_random_functor_id(this->random_generator);
+	int insertion_id = this->insertion_wheel.get_random_functor_id(this->random_generator);
+	DestroyOperator &destroy_operator = this->operator_registry.get_destroy_operator(destroy_id);
+	RepairOperator &insertion_operator = this->operator_registry.get_repair_operator(insertion_id);
+
+	// 3) Apply destroy and insertion operators
+	// 3.1) Perform operation
+	// We do not discriminate insertion / destroy to avoid overfitting
+	int64_t time_stamp = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	int64_t nr_evaluated_changes = this->running_solution.nr_evaluated_changes;
+	int64_t nr_rejected_changes = this->running_solution.nr_rejected_changes;
+
+	StatsClock::time_point operation_start = StatsClock::now();
+	destroy_operator(this->removed_customers);
+	int64_t destroy_time_ns = get_elapsed_ns(operation_start);
+
+	StatsClock::time_point step_start = StatsClock::now();
+	insertion_operator(this->removed_customers);
+	int64_t insertion_time_ns = get_elapsed_ns(step_start);
+
+	// operator statistics (search stats and wheels)
+	this->stats.destroy_calls[destroy_id]++;
+	this->stats.destroy_times_ns[destroy_id] += destroy_time_ns;
+	this->stats.insertion_calls[insertion_id]++;
+	this->stats.insertion_times_ns[insertion_id] += insertion_time_ns;
+	this->stats.nr_evaluated_changes += this->running_solution.nr_evaluated_changes - nr_evaluated_changes;
+	this->stats.nr_rejected_changes += this->running_solution.nr_rejected_changes - nr_rejected_changes;
+
+	this->destroy_wheel.log_execution_time(destroy_time_ns / 1e6);
+	this->insertion_wheel.log_execution_time(insertion_time_ns / 1e6);
+
+	// 3.2) Log solution for historic evaluation
+	step_start = StatsClock::now();
+	update_historic_matrices();
+	this->stats.historic_update_time_ns += get_elapsed_ns(step_start);
+
+	// 4) Process solution and evaluate it against other solutions
+	double operation_benefit = 0;
+
+	// 4.1) Identify if we already visited the solution (if so -> ignore best comparison)
+	// DEP: More info but more mem size_t count_sol = this->visited_solutions.count(this->running_solution);
+	// (the fingerprint is maintained by the solution -> no walk over the routes)
+	step_start = StatsClock::now();
+	size_t count_sol = this->visited_set.contains(this->running_solution.fingerprint);
+	this->stats.visited_lookup_time_ns += get_elapsed_ns(step_start);
+
+	// (if the previous solution is not visited count(0)->save it)
+	if (!count_sol) {
+		operation_benefit += this->functor_reward_unique;
+	}
 
-			// Randomly accept based on temperature
-			double random_int = UNI;
+	// 4.2) Compare running solution with current solution
+	double running_quality = this->running_solution.solution_quality;
+	double current_quality = this->current_solution.solution_quality;
 
-			if (random_int < diversity_relevance) {
-				this->current_solution = this->running_solution;
-			}
+
+	if (running_quality < current_quality) {
+		// Always accept strictly better solutions
+		// (only copy the changed routes, the solutions were identical before)
+		step_start = StatsClock::now();
+		this->running_solution.commit_journal(this->current_solution);
+		this->stats.solution_copy_time_ns += get_elapsed_ns(step_start);
+		operation_benefit += this->functor_reward_accept_better;
+	}
+	else {
+		double diversity_relevance = exp(-(running_quality - current_quality) / this->current_temperature);
+
+		double diversity = this->historic_matrices.get_diversity();
+		operation_benefit += diversity * diversity_relevance * this->functor_reward_divers;
+
+		// Not better than current -> cannot be better than global best
+		// (except in edge cases) because time != quality
+		operation_benefit += this->functor_penalty;
+
+		// Randomly accept based on temperature
+		double random_int = this->random_generator.uniform();
+
+		if (random_int < diversity_relevance) {
+			step_start = StatsClock::now();
+			this->running_solution.commit_journal(this->current_solution);
+			this->stats.solution_copy_time_ns += get_elapsed_ns(step_start);
 		}
+	}
 
-		// 4.3) Evaluate overall solution acceptance
-		if ((this->running_solution.driving_time < this->solution.driving_time) & (this->running_solution.is_feasible)) {
-			this->solution = this->running_solution;
-			operation_benefit += this->functor_reward_best;
+	// 4.3) Evaluate overall solution acceptance
+	bool is_improvement = (this->running_solution.driving_time < this->solution.driving_time) & (this->running_solution.is_feasible);
+	if (is_improvement) {
+		step_start = StatsClock::now();
+		this->solution = this->running_solution;
+		this->stats.solution_copy_time_ns += get_elapsed_ns(step_start);
+		operation_benefit += this->functor_reward_best;
 
-			// Reset the w.o. improvement run traits
-			iteration_wi=0;
+		// Reset the w.o. improvement run traits
+		this->iteration_wi = 0;
 
-			if (shakeup_log > 0) {
-				this->mean_removal = ceil(log(this->data_obj.nr_customer) / log(this->mean_removal_log));
-			}
+		if (shakeup_log > 0) {
+			this->mean_removal = ceil(log(this->data_obj.nr_customer) / log(this->mean_removal_log));
 		}
-		else {
-			// No improvement of overall solution
-			iteration_wi++;
+	}
+	else {
+		// No improvement of overall solution
+		this->iteration_wi++;
 
-			// Seems usefull? Else remvoe it!
-			if (shakeup_log > 0) {
-				this->mean_removal = ceil((log(iteration_wi + 1) / log(this->shakeup_log))*(log(this->data_obj.nr_customer) / log(this->mean_removal_log)));
-			}
+		// Seems usefull? Else remvoe it!
+		if (shakeup_log > 0) {
+			this->mean_removal = ceil((log(this->iteration_wi + 1) / log(this->shakeup_log))*(log(this->data_obj.nr_customer) / log(this->mean_removal_log)));
 		}
+	}
+
+	// 5) Prepare for next iteration
+	// 5.1) Save visited solutions for future iterations 
+	// (if the previous solution is not visited count(0)-> save it)
+	if (!count_sol) {
+		// Track the solution generation time to analyse later on!
+		step_start = StatsClock::now();
+		this->visited_set.insert(this->running_solution.fingerprint, time_stamp);
+		this->stats.visited_lookup_time_ns += get_elapsed_ns(step_start);
 
-		// 5) Prepare for next iteration
-		// 5.1) Save visited solutions for future iterations 
-		// (if the previous solution is not visited count(0)-> save it)
-		if (!count_sol) {
-			// Track the solution generation time to analyse later on!
+		if (this->log_full_solutions) {
 			this->visited_solutions[this->running_solution.solution_representation] = time_stamp;
-			// DEPRECTATED: (more mem but more info) this->visited_solutions[this->running_solution] = time_stamp;
 		}
+		// DEPRECTATED: (more mem but more info) this->visited_solutions[this->running_solution] = time_stamp;
+	}
 
-		// 5.2) Adjust infeasibility
-		if (!this->running_solution.is_feasible) {
-			this->inf_count++;
-		}
+	// 5.2) Adjust infeasibility
+	if (!this->running_solution.is_feasible) {
+		this->inf_count++;
+	}
 
-		// Adjust weights if the infeasibility rate is not sufficient
-		if (iteration_inf == 99) { // 99 because we start at 0
-			this->update_weights();
-			this->inf_count = 0;
-			iteration_inf = 0;
-		}
-		else {
-			iteration_inf++;
-		}
+	// Adjust weights if the infeasibility rate is not sufficient
+	if (this->iteration_inf == 99) { // 99 because we start at 0
+		this->update_weights();
+		this->inf_count = 0;
+		this->iteration_inf = 0;
+	}
+	else {
+		this->iteration_inf++;
+	}
 
-		// 5.2) Update last stats (consider the complete execution time to be fair)
-		__int64 execution_time = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count() - time_stamp + 1;
+	// 5.2) Update last stats (consider the complete execution time to be fair)
+	// (steady clock in ns -> no ms quantization of short iterations, +1 ms avoids the 0 division)
+	double execution_time = get_elapsed_ns(operation_start) / 1e6 + 1;
 
-		this->destroy_wheel.update_stats(operation_benefit/execution_time); // Keep track of last functor implicitly
-		this->insertion_wheel.update_stats(operation_benefit/execution_time);
+	this->destroy_wheel.update_stats(operation_benefit/execution_time); // Keep track of last functor implicitly
+	this->insertion_wheel.update_stats(operation_benefit/execution_time);
 
-		if (iteration % (this->operator_names_d.size()*wheel_memory_length) == 0) {
-			this->destroy_wheel.update_weights();
-		}
+	if (this->iteration % (this->operator_names_d.size()*wheel_memory_length) == 0) {
+		this->destroy_wheel.update_weights();
+	}
+
+	if (this->iteration % (this->operator_names_r.size()*wheel_memory_length) == 0) {
+		this->insertion_wheel.update_weights(); // Keep track of the removed and added weights implicitly
+	}
+
+	// 5.3) Progress log (new best solution or every progress_interval iterations, never waits)
+	if (this->progress_ring && (is_improvement || ((this->progress_interval > 0) && (this->iteration % this->progress_interval == 0)))) {
+		ProgressRecord record = { time_stamp,
+			this->iteration,
+			this->solution.driving_time,
+			this->current_solution.solution_quality,
+			this->current_temperature,
+			destroy_id,
+			insertion_id,
+			this->island_id,
+			is_improvement };
+
+		this->progress_ring->push(record);
+	}
+
+	// 5.4) Update cooling rate
+	this->current_temperature *= cooling_rate;
+	this->iteration++;
+
+	// 5.5) Set running solution
+	// Restore the changed routes if not accepted (no-op if the journal was committed)
+	step_start = StatsClock::now();
+	this->running_solution.rollback_journal(this->current_solution);
+	this->stats.solution_copy_time_ns += get_elapsed_ns(step_start);
+
+	// 5.6) Exchange solutions with the other islands (parallel solve only)
+	if ((this->migration_pool != nullptr) && (this->migration_interval > 0) && (this->iteration % this->migration_interval == 0)) {
+		step_start = StatsClock::now();
+		this->migrate();
+		this->stats.migration_time_ns += get_elapsed_ns(step_start);
+	}
+
+	this->stats.nr_iterations++;
+	this->stats.iteration_time_ns += get_elapsed_ns(iteration_start);
+	return time_stamp;
+}
+
+/**
+Exchange information with the other islands of a parallel solve
+
+	1) Offer the own best solution if it is the best of all islands
+	2) Take the best solution of all islands if it is better (restart from it)
+	3) Merge the node pair potentials (optional)
+
+Annotation:
+	Must be called when running and current solution are identical (end of an iteration)
+*/
+void ALNS::migrate() {
+	lock_guard<mutex> guard(this->migration_pool->lock);
+	Solution &pool_best = this->migration_pool->best_solution;
+
+	if (this->solution.driving_time < pool_best.driving_time) {
+		pool_best = this->solution;
+	}
+	else if (pool_best.driving_time < this->solution.driving_time) {
+		this->solution = pool_best;
+
+		// The quality depends on the island specific infeasibility weights
+		this->current_solution = pool_best;
+		this->current_solution.set_quality(this->capa_error_weight, this->frame_error_weight);
+		this->running_solution = this->current_solution;
+	}
+
+	if (this->share_potential_matrix) {
+		this->historic_matrices.merge_potentials(this->migration_pool->node_pair_potential_matrix);
+	}
+}
+
+/**
+Parallel solve based on the island model
+
+Each thread runs its own ALNS (own solutions, wheels and random generator)
+on the same read only data object. Every [migration_interval] iterations
+the islands exchange their best solutions (see migrate).
 
-		if (iteration % (this->operator_names_r.size()*wheel_memory_length) == 0) {
-			this->insertion_wheel.update_weights(); // Keep track of the removed and added weights implicitly
+The results of all islands are summarized in this object:
+	- solution:				Best solution of all islands
+	- iterations:			Sum of all iterations
+	- visited_set:			Union of all visited solutions (and visited_solutions if logged)
+*/
+Solution ALNS::solve_parallel() {
+	int64_t start = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	MigrationPool pool(this->data_obj, this->cancel_requested);
+
+	// 0) Start of all islands: the given routes or the best constructed start (constructed once, in parallel)
+	vector<vector<int>> initial_routes = this->initial_routes;
+	if (initial_routes.empty() && (this->construction_heuristic != construction::RANDOM)) {
+		this->initial_routes = this->construct_initial_routes();
+	}
+
+	// 1) Create the islands (this object is the first island, no islands after a cancel)
+	vector<unique_ptr<ALNS>> islands;
+	int nr_islands = this->is_cancelled() ? 1 : this->num_threads;
+	for (int island_id = 1; island_id < nr_islands; island_id++) {
+		islands.push_back(unique_ptr<ALNS>(new ALNS(this->data_obj,
+			this->operator_names_d,
+			this->operator_names_r,
+			this->max_time,
+			this->max_iterations,
+			this->init_temperature,
+			this->cooling_rate,
+			this->wheel_memory_length,
+			this->wheel_parameter,
+			this->functor_reward_best,
+			this->functor_reward_accept_better,
+			this->functor_reward_unique,
+			this->functor_reward_divers,
+			this->functor_penalty,
+			this->functor_min_weight,
+			this->random_noise,
+			this->target_inf,
+			this->shakeup_log,
+			this->mean_removal_log,
+			1,
+			this->migration_interval,
+			this->share_potential_matrix,
+			int(this->random_generator() >> 1), // derived seed -> reproducible if this object is seeded
+			this->log_full_solutions)));
+
+		islands.back()->migration_pool = &pool;
+
+		// all islands write into the progress log of this object
+		islands.back()->progress_ring = this->progress_ring;
+		islands.back()->progress_interval = this->progress_interval;
+		islands.back()->island_id = island_id;
+
+		// same warm start as this object
+		islands.back()->set_initial_solution(this->initial_routes);
+		if (this->has_search_memory) {
+			islands.back()->set_search_memory(this->search_memory);
 		}
+	}
+	this->migration_pool = &pool;
 
-		// 5.3) Update cooling rate
-		current_temperature *= cooling_rate;
-		iteration++;
+	// 2) Run all islands (each with its own random generator)
+	vector<thread> threads;
+	threads.push_back(thread([this]() {
+		this->solve();
+	}));
 
-		// 5.4) Set running solution
-		this->running_solution = this->current_solution; // Deep copy (self declared)
+	for (unique_ptr<ALNS> &island : islands) {
+		ALNS *island_ptr = island.get();
 
-		// 5.6) reset time tracking
-		prev_time_stamp = time_stamp;
+		threads.push_back(thread([island_ptr]() {
+			island_ptr->solve();
+		}));
 	}
 
-	// Report the final KPIs without service times (standard reporting)
-	this->iterations = iteration;
-	this->solution_time_ms = prev_time_stamp - start;
+	for (thread &t : threads) {
+		t.join();
+	}
+	this->migration_pool = nullptr;
+	this->initial_routes = initial_routes;
+	this->cancel_requested = false;
+
+	// 3) Summarize the results
+	for (unique_ptr<ALNS> &island : islands) {
+		if (island->solution.driving_time < this->solution.driving_time) {
+			this->solution = island->solution;
+		}
+
+		this->iterations += island->iterations;
+		this->destroy_wheel.merge_statistics(island->destroy_wheel);
+		this->insertion_wheel.merge_statistics(island->insertion_wheel);
+		this->stats.merge(island->stats);
+		this->visited_set.merge(island->visited_set);
+		this->visited_solutions.insert(island->visited_solutions.begin(), island->visited_solutions.end());
+	}
+
+	this->solution_time_ms = int(chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch()).count() - start);
 	this->value = this->solution.driving_time;
 
-	cout << "INFO:c++: solving (DONE)" << endl;
 	return this->solution;
-}
\ No newline at end of file
+}
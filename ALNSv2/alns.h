@@ -20,12 +20,60 @@
 #include "alns_data.h"
 #include "solution.h"
 #include "operator.h"
+#include "operator_registry.h"
 #include "roulette_wheel.h"
+#include "visited_set.h"
+#include "historic_matrices.h"
+#include "search_stats.h"
+#include "construction.h"
+#include "progress_ring.h"
 #include <unordered_map>
 #include <vector>
 #include <string>
 #include <functional>
 #include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+/**
+Shared state of a parallel (island model) solve
+
+Each island (ALNS worker) periodically offers its best solution and takes
+the best solution of all islands if it is better than its own.
+All members except the cancel flag are protected by the mutex!
+*/
+struct MigrationPool {
+	std::mutex lock;
+	Solution best_solution; // best feasible solution of all islands
+	std::vector<float> node_pair_potential_matrix; // merged (min) potentials, flat [from*nr_nodes + to]
+	const std::atomic<bool> &cancel_requested; // cancel flag of the parallel solving object
+
+	MigrationPool(ALNSData &data_obj, const std::atomic<bool> &cancel_requested) :
+		best_solution(data_obj),
+		node_pair_potential_matrix(std::size_t(data_obj.nr_nodes)*data_obj.nr_nodes, std::numeric_limits<float>::max()),
+		cancel_requested(cancel_requested) {};
+};
+
+/**
+Learned state of a search that can seed another search (warm start)
+
+	1) Wheel weights of the operators (by operator name)
+	2) Node pair potentials and usages, flat [from*nr_nodes + to] (node = customer + 1, depot = 0)
+
+See ALNS::get_search_memory and ALNS::set_search_memory
+*/
+struct SearchMemory {
+	std::vector<std::string> destroy_operators;
+	std::vector<double> destroy_weights;
+	std::vector<std::string> repair_operators;
+	std::vector<double> repair_weights;
+
+	int nr_nodes = 0;
+	std::vector<float> node_pair_potential_matrix;
+	std::vector<std::uint32_t> node_pair_usage_matrix;
+};
 
 class ALNS {
 private:
@@ -60,27 +108,63 @@ private:
 	double const mean_removal_log;
 	double mean_removal;
 
+	// parallel settings
+	int const num_threads;
+	int const migration_interval;
+	bool const share_potential_matrix;
+	bool const log_full_solutions;
+	MigrationPool *migration_pool = nullptr; // Set if this object is an island of a parallel solve
+
 	// private dynamic attributes
+	tools::RandomGenerator random_generator; // Used by all operators and wheels of this object
+	OperatorScratch operator_scratch; // Reusable buffers of all operators of this object
+	std::vector<int> removed_customers; // removal list of the current iteration (destroy -> repair)
 	double inf_count;
-	std::vector<std::vector<double>> node_pair_potential_matrix; // node based!
-	std::vector<std::vector<int>> node_pair_useage_matrix; // node based!
+	HistoricMatrices historic_matrices; // node pair potentials and usages (node based!)
 
 	// pointer to all dynamic attributes -> Dont copy the contents!
 	Solution current_solution;
 
+	// warm start (see set_initial_solution / set_search_memory, passed to the islands)
+	std::vector<std::vector<int>> initial_routes; // empty -> construction heuristic
+	SearchMemory search_memory; // memory of another search in the node ids of this data object
+	bool has_search_memory = false;
+
+	// construction of the initial solution (see set_construction_heuristic)
+	construction::Heuristic construction_heuristic = construction::RANDOM;
+	int nr_construction_seeds = 1;
+
+	// progress log (see set_progress_log, the ring is shared with the islands)
+	std::shared_ptr<ProgressRing> progress_ring; // null -> disabled
+	int progress_interval = 0;
+	int island_id = 0; // 0: solving object
+
+	// search state (kept between the time slices of solve_for)
+	bool search_started = false;
+	std::atomic<bool> search_finished{ false }; // read by is_search_finished (any thread)
+	double current_temperature = 0;
+	int iteration = 0;
+	int iteration_wi = 0; // nr iterations without improvement
+	int iteration_inf = 0; // current infeasibility pointer for vector
+	std::int64_t search_time_ms = 0; // summed over all time slices
+	std::atomic<bool> cancel_requested{ false }; // set by cancel (any thread), cleared when the search ends
+
 public:
 	// Necessary runtime public instance
 	Solution running_solution;
 
 	// Data interface
-	// DEPRECTATED: (more mem but more info) std::unordered_map<Solution, __int64> visited_solutions;
-	std::unordered_map<std::vector<std::vector<int>>, __int64> visited_solutions;
+	// DEPRECTATED: (more mem but more info) std::unordered_map<Solution, std::int64_t> visited_solutions;
+	VisitedSet visited_set; // Fingerprints and first visit time stamps of all visited solutions
+	std::unordered_map<std::vector<std::vector<int>>, std::int64_t> visited_solutions; // Full copies (only if log_full_solutions)
 
 	double capa_error_weight;
 	double frame_error_weight;
 
+	OperatorRegistry operator_registry; // All operators of this object (ids of the wheels)
 	DestroyRouletteWheel destroy_wheel;
 	InsertionRouletteWheel insertion_wheel;
+	SearchStats stats; // Instrumentation of the current search (reset by a new search)
 
 	ALNSData &data_obj; // We use a pointer so that we dont have to copy the complete object!
 	Solution solution; // Final solution if once solved!!
@@ -108,13 +192,78 @@ public:
 		double random_noise = 0,
 		double target_inf = 0.2,
 		double shakeup_log_log = 20,
-		double mean_removal_log = 2);
+		double mean_removal_log = 2,
+		int num_threads = 1,
+		int migration_interval = 1000,
+		bool share_potential_matrix = false,
+		int seed = -1,
+		bool log_full_solutions = false);
 
 	// public functions
 	void initialization();
 	void update_historic_matrices();
 	void update_weights();
-	std::vector < std::function<std::vector<int>()>> get_destroy_functors();
-	std::vector< std::function<void(std::vector<int>)>> get_insertion_functors();
 	Solution solve(); // give all tuneable parameters to "solve"
+
+	// Warm start: solve from the given routes / solution (see set_initial_solution)
+	Solution solve(const std::vector<std::vector<int>> &initial_routes);
+	Solution solve(const Solution &initial_solution);
+
+	/**
+	Start all following searches from the routes instead of a random solution (empty: random)
+	Customers missing in the routes (e.g. newly arrived) are inserted by the basic greedy
+	insertion -> re-optimisation of an existing plan.
+	*/
+	void set_initial_solution(const std::vector<std::vector<int>> &initial_routes);
+
+	/**
+	Construction heuristic of the initial solution of the following searches (without initial solution)
+		"random" (default), "savings", "solomon_i1" or "sweep" (see construction.h)
+	[nr_seeds] randomized trials run on num_threads threads, the best start is kept.
+	A parallel solve constructs once and starts all islands from the best start.
+	*/
+	void set_construction_heuristic(const std::string &heuristic, int nr_seeds = 1);
+	std::string get_construction_heuristic() const { return construction::get_heuristic_name(this->construction_heuristic); }
+
+	/**
+	Progress log of the following searches (lock free ring, see progress_ring.h)
+	A record (time stamp, iteration, incumbent, temperature, operators) is written whenever the best
+	solution of an island improves and every [interval] iterations (0: improvements only).
+	Set it before the search ([capacity] 0: disabled), drain it from any thread while the search is running.
+	*/
+	void set_progress_log(int capacity, int interval = 0);
+	std::vector<ProgressRecord> drain_progress(std::int64_t max_records = -1);
+	std::int64_t get_nr_dropped_progress() const;
+
+	/**
+	Learned state of this object (wheels, historic matrices) to seed another search
+	The memory of a search can be carried over to an ALNS of another (e.g. updated) data object:
+		- operator weights by name (operators unknown to the memory get the mean weight)
+		- node pair matrices mapped by [node_map]: old node id -> node id of this data object
+		  (-1: dropped, empty map: nodes with equal ids)
+	*/
+	SearchMemory get_search_memory() const;
+	void set_search_memory(const SearchMemory &memory, const std::vector<int> &node_map = std::vector<int>());
+
+	// Time sliced search (single thread only): resumes the search state of the previous call
+	Solution solve_for(int time_ms);
+	void reset_search(); // next solve_for starts a new search
+	bool is_search_finished() const { return this->search_finished; }
+
+	// Thread safe: stops the running search after the current iteration
+	// (a cancel before the search or during its initialization stops the next search)
+	void cancel() { this->cancel_requested = true; }
+
+private:
+	// search steps (see solve)
+	void warm_start_initialization(const std::vector<std::vector<int>> &routes);
+	std::vector<std::vector<int>> construct_initial_routes();
+	void start_search();
+	void run_search(std::int64_t max_slice_ms);
+	std::int64_t iterate();
+	bool is_cancelled() const;
+
+	// island model
+	Solution solve_parallel();
+	void migrate();
 };
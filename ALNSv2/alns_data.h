@@ -5,14 +5,32 @@ Can be reduced and simultaneously used for VRP and VRPTW
 */
 #pragma once
 #include "tools.h"
+#include "time_cube.h"
 #include <iostream>
 #include <vector>
+#include <string>
 #include <algorithm> // max element
+#include <utility> // move
+#include <cmath> // ceil
+#include <stdexcept>
 
 struct ALNSData {
 private:
 	void general_preprocessing();
-	void vrpldtt_preprocessing();
+	void vrpldtt_preprocessing(bool compress_time_cube);
+
+	// Data file constructor (all other attributes are set in load_mmap)
+	ALNSData(int nr_veh,
+		int nr_nodes,
+		int nr_cust,
+		int vehicle_weight,
+		int vehicle_cap) :
+		nr_vehicles(nr_veh),
+		nr_nodes(nr_nodes),
+		nr_customer(nr_cust),
+		vehicle_weight(vehicle_weight),
+		vehicle_cap(vehicle_cap),
+		load_bucket_size() {};
 
 public:
 	// DATA
@@ -38,19 +56,65 @@ public:
 
 	// derived by preprocessing
 	std::vector<std::vector<double>> slope_matrix;
-	std::vector<std::vector<std::vector<double>>> time_cube;
-	std::vector<std::vector<double>> norm_distance_matrix;
-	std::vector<std::vector<double>> norm_start_window_matrix;
-	std::vector<std::vector<double>> norm_end_window_matrix;
-	std::vector<std::vector<double>> norm_demand_matrix;
+	TimeCube time_cube; // flat [bucket][from][to] or compressed (see time_cube.h)
+
+	// min max normalization of the shaw relatedness (see get_norm_distance)
+	double min_distance = 0;
+	double distance_range = 0;
+	double start_window_range = 0;
+	double end_window_range = 0;
+	double demand_range = 0;
+
+	// granular neighbourhood (empty if disabled, see set_candidate_lists)
+	int nr_candidates = 0;
+	std::vector<std::vector<int>> candidate_lists;		// customer based, most related first
+	std::vector<std::vector<bool>> candidate_matrix;	// [customer][customer] -> is a candidate
 
 	// FUNCTIONS
+	// Compute the k nearest candidates per customer (k <= 0 disables it)
+	void set_candidate_lists(int nr_candidates);
+
+	/**
+	Distance between two nodes
+	VRPTW stores no distance matrix: the travel time of the empty vehicle is used instead
+	*/
+	inline double get_distance(int from, int to) const {
+		return this->distance_matrix.empty() ? this->time_cube(0, from, to) : this->distance_matrix[from][to];
+	}
+
+	/**
+	Normalized relatedness terms of the shaw removal in [0, 1] (computed on the fly)
+	The distance is node based (customer id + 1), the other terms are customer based.
+	*/
+	inline double get_norm_distance(int from, int to) const {
+		return (this->get_distance(from, to) - this->min_distance) / this->distance_range;
+	}
+
+	inline double get_norm_start_window(int i, int j) const {
+		return std::abs(this->start_window[i] - this->start_window[j]) / this->start_window_range;
+	}
+
+	inline double get_norm_end_window(int i, int j) const {
+		return std::abs(this->end_window[i] - this->end_window[j]) / this->end_window_range;
+	}
+
+	inline double get_norm_demand(int i, int j) const {
+		return std::abs(this->demand[i] - this->demand[j]) / this->demand_range;
+	}
+
+	// Binary data file (see data_file.cpp)
+	void save(const std::string &path) const;
+	static ALNSData load_mmap(const std::string &path);
+
 	// Default constructor (used for Solution pickling)
 	ALNSData(): load_bucket_size() {};
 
 	/**
 	VRPLDTT constructor
 	The time cube is computed in preprocessing
+
+	@param compress_time_cube:	Store load invariant arcs once (compressed layout, see time_cube.h)
+								-> less memory for fine load buckets
 	*/
 	ALNSData(int nr_veh,
 		int nr_nodes,
@@ -64,7 +128,8 @@ public:
 		double load_bucket_size=-1,
 		double nr_load_buckets=-1,
 		int vehicle_weight=140,
-		int vehicle_cap=150) :
+		int vehicle_cap=150,
+		bool compress_time_cube=false) :
 		nr_vehicles(nr_veh),
 		nr_nodes(nr_nodes),
 		nr_customer(nr_cust),
@@ -84,7 +149,7 @@ public:
 			this->load_bucket_size = load_bucket_size;
 		}
 		else {
-			throw std::exception("Unexpected error: Neither interval size nor number of intervalls given.");
+			throw std::runtime_error("Unexpected error: Neither interval size nor number of intervalls given.");
 		}
 
 
@@ -93,7 +158,7 @@ public:
 
 		this->add_pseudo_capacity = int(std::ceil(*std::max_element(demand.begin(), demand.end())));
 		this->general_preprocessing();
-		this->vrpldtt_preprocessing();
+		this->vrpldtt_preprocessing(compress_time_cube);
 
 		std::cout << "INFO:c++: preprocessing (DONE)" << std::endl;
 	}
@@ -111,6 +176,28 @@ public:
 		std::vector<double> end_window,
 		std::vector<std::vector<std::vector<double>>> time_c,
 		int vehicle_cap = 200) :
+		ALNSData(nr_veh,
+			nr_nodes,
+			nr_cust,
+			demand,
+			service_times,
+			start_window,
+			end_window,
+			TimeCube(time_c),
+			vehicle_cap) {};
+
+	/**
+	VRPTW constructor with a flat time cube (e.g. filled from a numpy buffer)
+	*/
+	ALNSData(int nr_veh,
+		int nr_nodes,
+		int nr_cust,
+		std::vector<double> demand,
+		std::vector<double> service_times,
+		std::vector<double> start_window,
+		std::vector<double> end_window,
+		TimeCube time_c,
+		int vehicle_cap = 200) :
 		nr_vehicles(nr_veh),
 		nr_nodes(nr_nodes),
 		nr_customer(nr_cust),
@@ -118,12 +205,13 @@ public:
 		service_times(service_times),
 		start_window(start_window),
 		end_window(end_window),
-		distance_matrix(time_c[0]), // Distance matrix is relevant for shaw and equivalent to the time_cube
-		time_cube(time_c),
+		time_cube(std::move(time_c)),
 		load_bucket_size(vehicle_cap*2), // Infeas Upper bound. A smarter upper bound has no efficiency gain
 		vehicle_weight(0),
 		vehicle_cap(vehicle_cap)
 	{
+		// No distance matrix: the distance of shaw is the time cube (see get_distance)
+
 		// perform preprocessing
 		std::cout << "INFO:c++: preprocessing (START)" << std::endl;
 
@@ -0,0 +1,113 @@
+/**
+This file contains the batch solve on a native thread pool (see batch_solve.h)
+*/
+#include "batch_solve.h"
+#include "alns.h"
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+Utility function to run one job (the ALNS object only lives within the call)
+*/
+BatchResult run_batch_job(const BatchJob &job) {
+	const BatchParameters &parameters = job.parameters;
+
+	ALNS alns(*job.data_obj,
+		parameters.destroy_operators,
+		parameters.repair_operators,
+		parameters.max_time,
+		parameters.max_iterations,
+		parameters.init_temperature,
+		parameters.cooling_rate,
+		parameters.wheel_memory_length,
+		parameters.wheel_parameter,
+		parameters.functor_reward_best,
+		parameters.functor_reward_accept_better,
+		parameters.functor_reward_unique,
+		parameters.functor_reward_divers,
+		parameters.functor_penalty,
+		parameters.functor_min_weight,
+		parameters.random_noise,
+		parameters.target_inf,
+		parameters.shakeup_log,
+		parameters.mean_removal_log,
+		parameters.num_threads,
+		parameters.migration_interval,
+		parameters.share_potential_matrix,
+		parameters.seed,
+		false);
+
+	alns.set_construction_heuristic(parameters.construction_heuristic, parameters.nr_construction_seeds);
+	alns.solve();
+
+	BatchResult result;
+	result.value = alns.value;
+	result.iterations = alns.iterations;
+	result.solution_time_ms = alns.solution_time_ms;
+	result.is_feasible = (alns.value < numeric_limits<double>::max());
+	return result;
+}
+
+vector<BatchResult> solve_batch(const vector<BatchJob> &jobs, int num_threads) {
+	for (const BatchJob &job : jobs) {
+		if (job.data_obj == nullptr) {
+			throw invalid_argument("Each job of the batch needs a data object");
+		}
+	}
+
+	if (num_threads <= 0) {
+		num_threads = max(1, int(thread::hardware_concurrency()));
+	}
+	num_threads = max(1, min(num_threads, int(jobs.size())));
+
+	vector<BatchResult> results(jobs.size());
+	atomic<size_t> next_job_id(0);
+	atomic<bool> has_failed(false);
+	exception_ptr error;
+	mutex error_lock;
+
+	// idle threads take the next job
+	auto run_jobs = [&]() {
+		while (!has_failed) {
+			size_t job_id = next_job_id.fetch_add(1);
+			if (job_id >= jobs.size()) {
+				break;
+			}
+
+			try {
+				results[job_id] = run_batch_job(jobs[job_id]);
+			}
+			catch (...) {
+				lock_guard<mutex> guard(error_lock);
+				if (!error) {
+					error = current_exception();
+				}
+				has_failed = true;
+			}
+		}
+	};
+
+	vector<thread> threads;
+	for (int thread_id = 1; thread_id < num_threads; thread_id++) {
+		threads.push_back(thread(run_jobs));
+	}
+	run_jobs();
+
+	for (thread &t : threads) {
+		t.join();
+	}
+
+	if (error) {
+		rethrow_exception(error);
+	}
+	return results;
+}
@@ -0,0 +1,66 @@
+/**
+Batch solve of many independent ALNS runs on a native thread pool (parameter tuning, computational analysis)
+
+Each job is one ALNS object (data object, parameters). Identical data objects are shared by reference
+(read only during the search) -> no copies or serialization per run. The jobs are taken dynamically
+by idle threads (shared job counter), only one ALNS object per thread is alive at a time.
+
+Annotation:
+	The jobs are coarse and independent -> one shared counter balances the load as well as per thread
+	queues with stealing would. A job with num_threads > 1 runs its islands in addition to the batch threads.
+	The first exception of a job stops the remaining jobs and is rethrown (after all threads finished).
+*/
+#pragma once
+#include "alns_data.h"
+#include <vector>
+#include <string>
+
+// Parameters of one ALNS run (see the ALNS constructor, defaults of the python constructor)
+struct BatchParameters {
+	std::vector<std::string> destroy_operators;
+	std::vector<std::string> repair_operators;
+	int max_time = 600;
+	double max_iterations = 10000;
+	double init_temperature = 0.01;
+	double cooling_rate = 0.99975;
+	int wheel_memory_length = 20;
+	double wheel_parameter = 0.1;
+	double functor_reward_best = 33;
+	double functor_reward_accept_better = 13;
+	double functor_reward_unique = 9;
+	double functor_reward_divers = 9;
+	double functor_penalty = 0;
+	double functor_min_weight = 1;
+	double random_noise = 0;
+	double target_inf = 0.2;
+	double shakeup_log = 20;
+	double mean_removal_log = 2;
+	int num_threads = 1;
+	int migration_interval = 1000;
+	bool share_potential_matrix = false;
+	int seed = -1;
+
+	// construction of the initial solution (see ALNS::set_construction_heuristic)
+	std::string construction_heuristic = "random";
+	int nr_construction_seeds = 1;
+};
+
+struct BatchJob {
+	ALNSData *data_obj; // not owned, must outlive the batch
+	BatchParameters parameters;
+};
+
+// Compact result of one job
+struct BatchResult {
+	double value = -1;			// driving time of the best solution (max double: no feasible solution)
+	int iterations = 0;
+	int solution_time_ms = 0;
+	bool is_feasible = false;
+};
+
+/**
+Solve all jobs on [num_threads] threads (<= 0: all hardware threads)
+
+@return:	One result per job (order of the jobs)
+*/
+std::vector<BatchResult> solve_batch(const std::vector<BatchJob> &jobs, int num_threads);
@@ -0,0 +1,88 @@
+/**
+Benchmark of the ALNSData construction (VRPLDTT preprocessing) against the number of nodes
+
+Random euclidean instances with random elevations are generated for each node count.
+The construction time (slope matrix, time cube, normalization bounds) is reported per instance.
+
+Usage:
+	preprocessing_benchmark [nr_load_buckets] [node_count_1 node_count_2 ...]
+	(default: 20 buckets, 50 100 200 500 1000 nodes)
+
+Compile with all ALNSv2 sources except module.cpp
+*/
+#include "../alns_data.h"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+using namespace std;
+
+/**
+Construct a random VRPLDTT data object and return the construction time in ms
+*/
+double time_data_construction(int nr_nodes, double nr_load_buckets, mt19937 &random_generator) {
+	uniform_real_distribution<double> coordinate(0.0, 10.0); // km
+	uniform_real_distribution<double> height(0.0, 100.0); // m
+	uniform_real_distribution<double> customer_demand(5.0, 25.0);
+
+	int nr_customers = nr_nodes - 1;
+	vector<double> x(nr_nodes), y(nr_nodes), z(nr_nodes);
+	for (int i = 0; i < nr_nodes; i++) {
+		x[i] = coordinate(random_generator);
+		y[i] = coordinate(random_generator);
+		z[i] = height(random_generator);
+	}
+
+	vector<vector<double>> distance_matrix(nr_nodes, vector<double>(nr_nodes));
+	vector<vector<double>> elevation_matrix(nr_nodes, vector<double>(nr_nodes));
+	for (int i = 0; i < nr_nodes; i++) {
+		for (int j = 0; j < nr_nodes; j++) {
+			double ground = sqrt((x[i] - x[j])*(x[i] - x[j]) + (y[i] - y[j])*(y[i] - y[j]));
+			double rise = z[j] - z[i];
+			distance_matrix[i][j] = sqrt(ground*ground + (rise / 1000)*(rise / 1000));
+			elevation_matrix[i][j] = rise;
+		}
+	}
+
+	vector<double> demand(nr_customers), service_times(nr_customers, 5.0);
+	vector<double> start_window(nr_customers, 0.0), end_window(nr_customers, 480.0);
+	for (int i = 0; i < nr_customers; i++) {
+		demand[i] = customer_demand(random_generator);
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	ALNSData data(nr_customers / 10 + 1, nr_nodes, nr_customers,
+		demand, service_times, start_window, end_window,
+		elevation_matrix, distance_matrix,
+		-1, nr_load_buckets);
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+	return chrono::duration<double, milli>(end - start).count();
+}
+
+int main(int argc, char **argv) {
+	double nr_load_buckets = argc > 1 ? atof(argv[1]) : 20;
+
+	vector<int> node_counts;
+	for (int arg = 2; arg < argc; arg++) {
+		node_counts.push_back(atoi(argv[arg]));
+	}
+	if (node_counts.empty()) {
+		node_counts = { 50, 100, 200, 500, 1000 };
+	}
+
+	mt19937 random_generator(42);
+	vector<double> times;
+	for (int nr_nodes : node_counts) {
+		times.push_back(time_data_construction(nr_nodes, nr_load_buckets, random_generator));
+	}
+
+	printf("%10s %10s %14s\n", "nodes", "buckets", "construct_ms");
+	for (unsigned int i = 0; i < node_counts.size(); i++) {
+		printf("%10d %10.0f %14.2f\n", node_counts[i], nr_load_buckets, times[i]);
+	}
+	return 0;
+}
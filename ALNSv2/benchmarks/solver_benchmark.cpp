@@ -0,0 +1,477 @@
+/**
+Micro and macro benchmarks of the solver (regression tracking)
+
+Random instances with the dimensions of the imported benchmark sets (see CompAnalysis/data_import)
+are generated with a fixed seed:
+	1) solomon_100:		VRPTW, 100 customers, 25 vehicles, capacity 200 (single time cube bucket)
+	2) cordeau_144:		VRPTW, 144 customers, 20 vehicles, capacity 200 (single time cube bucket)
+	3) fontaine_20:		VRPLDTT, 20 customers, 10 load buckets, capacity 150, vehicle weight 140
+
+Macro:	ALNS::solve with all operators at a fixed seed and iteration limit (single thread)
+		(the limit counts the iterations without improvement, see ALNS::run_search)
+Micro:	Mean time per call on the final running solution of the macro benchmark
+		(velocity_calculation, get_time_cube (dense and compressed), evaluate_change, get_best_insertion,
+		Solution::operator=, every destroy and repair operator, the construction heuristics)
+
+The results are written as JSON (one object per instance) and printed as table.
+
+Usage:
+	solver_benchmark [json_path] [nr_iterations] [nr_repetitions]
+	(default: solver_benchmark.json, 2000 iterations, 100 repetitions)
+
+Annotation:
+	The operator scores of the wheels contain the operator runtime,
+	the search trajectory is therefore only reproducible up to the timing.
+
+Compile with all ALNSv2 sources except module.cpp
+*/
+#include "../alns.h"
+#include "../alns_data.h"
+#include "../solution.h"
+#include "../operator_scratch.h"
+#include "../search_stats.h"
+#include "../construction.h"
+#include "../tools.h"
+#include <vector>
+#include <string>
+#include <tuple>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+// Free functions of preprocessing.cpp and operator.cpp (not part of a header)
+void velocity_calculation(const double mass,
+	const double *slope_resistances,
+	double *velocities,
+	const int nr_arcs,
+	const bool warm_start);
+
+TimeCube get_time_cube(const vector<vector<double>> &distance_matrix,
+	const vector<vector<double>> &slope_matrix,
+	const double vehicle_weight,
+	const double vehicle_capacity,
+	const double add_pseudo_capacity,
+	double weight_interval_size,
+	const bool compressed);
+
+tuple<double, int, int> get_best_insertion(
+	int customer_id,
+	Solution &solution_obj,
+	double const &capa_error_weight,
+	double const &frame_error_weight,
+	OperatorScratch &scratch,
+	int route_id,
+	bool granular,
+	bool prune);
+
+const vector<string> DESTROY_OPERATORS = { "random_destroy", "route_destroy", "demand_destroy", "time_destroy",
+	"worst_destroy", "node_pair_destroy", "shaw_destroy", "distance_similarity", "window_similarity", "demand_similarity" };
+const vector<string> REPAIR_OPERATORS = { "basic_greedy", "random_greedy", "deep_greedy", "2_regret", "3_regret", "5_regret", "beta_hybrid" };
+
+const int SEED = 42;
+
+struct BenchmarkResult {
+	string name;
+	double ns_per_call;
+};
+
+struct InstanceResult {
+	string name;
+	string problem_type;
+	int nr_customers;
+	int nr_vehicles;
+	int nr_buckets;
+
+	// macro benchmark
+	double solve_time_ms;
+	double value;
+	int iterations;
+	SearchStats stats;
+
+	// micro benchmarks
+	vector<BenchmarkResult> micro;
+};
+
+/**
+Utility function to get the mean runtime of a function in ns (whole loop timed)
+*/
+template <typename Function>
+double get_ns_per_call(int nr_calls, Function function) {
+	StatsClock::time_point start = StatsClock::now();
+	for (int call = 0; call < nr_calls; call++) {
+		function();
+	}
+	return double(get_elapsed_ns(start)) / nr_calls;
+}
+
+/**
+Random euclidean VRPTW instance in the Solomon / Cordeau format (time cube = distances)
+*/
+ALNSData get_vrptw_data(int nr_customers, int nr_vehicles, int vehicle_cap, double horizon, mt19937 &random_generator) {
+	uniform_real_distribution<double> coordinate(0.0, 100.0);
+	uniform_real_distribution<double> customer_demand(1.0, 40.0);
+	uniform_real_distribution<double> window_start(0.0, horizon * 0.8);
+	uniform_real_distribution<double> window_width(10.0, horizon * 0.2);
+
+	int nr_nodes = nr_customers + 1;
+	vector<double> x(nr_nodes), y(nr_nodes);
+	for (int i = 0; i < nr_nodes; i++) {
+		x[i] = coordinate(random_generator);
+		y[i] = coordinate(random_generator);
+	}
+
+	TimeCube time_cube(1, nr_nodes);
+	for (int i = 0; i < nr_nodes; i++) {
+		for (int j = 0; j < nr_nodes; j++) {
+			time_cube.at(0, i, j) = sqrt((x[i] - x[j])*(x[i] - x[j]) + (y[i] - y[j])*(y[i] - y[j]));
+		}
+	}
+
+	vector<double> demand(nr_customers), service_times(nr_customers, 10.0);
+	vector<double> start_window(nr_customers), end_window(nr_customers);
+	for (int i = 0; i < nr_customers; i++) {
+		// (as in the benchmark sets: each window is reachable from the depot)
+		demand[i] = round(customer_demand(random_generator));
+		start_window[i] = max(round(window_start(random_generator)), ceil(time_cube(0, 0, i + 1)));
+		end_window[i] = start_window[i] + round(window_width(random_generator));
+	}
+
+	return ALNSData(nr_vehicles, nr_nodes, nr_customers,
+		demand, service_times, start_window, end_window,
+		time_cube, vehicle_cap);
+}
+
+/**
+Random VRPLDTT instance in the Fontaine format (km distances, m elevations)
+*/
+ALNSData get_vrpldtt_data(int nr_customers, double nr_load_buckets, mt19937 &random_generator) {
+	uniform_real_distribution<double> coordinate(0.0, 10.0); // km
+	uniform_real_distribution<double> height(0.0, 100.0); // m
+	uniform_real_distribution<double> customer_demand(5.0, 25.0);
+	uniform_real_distribution<double> window_start(0.0, 300.0);
+	uniform_real_distribution<double> window_width(30.0, 120.0);
+
+	int nr_nodes = nr_customers + 1;
+	vector<double> x(nr_nodes), y(nr_nodes), z(nr_nodes);
+	for (int i = 0; i < nr_nodes; i++) {
+		x[i] = coordinate(random_generator);
+		y[i] = coordinate(random_generator);
+		z[i] = height(random_generator);
+	}
+
+	vector<vector<double>> distance_matrix(nr_nodes, vector<double>(nr_nodes));
+	vector<vector<double>> elevation_matrix(nr_nodes, vector<double>(nr_nodes));
+	for (int i = 0; i < nr_nodes; i++) {
+		for (int j = 0; j < nr_nodes; j++) {
+			double ground = sqrt((x[i] - x[j])*(x[i] - x[j]) + (y[i] - y[j])*(y[i] - y[j]));
+			double rise = z[j] - z[i];
+			distance_matrix[i][j] = sqrt(ground*ground + (rise / 1000)*(rise / 1000));
+			elevation_matrix[i][j] = rise;
+		}
+	}
+
+	vector<double> demand(nr_customers), service_times(nr_customers, 5.0);
+	vector<double> start_window(nr_customers), end_window(nr_customers);
+	for (int i = 0; i < nr_customers; i++) {
+		demand[i] = customer_demand(random_generator);
+		start_window[i] = window_start(random_generator);
+		end_window[i] = start_window[i] + window_width(random_generator);
+	}
+
+	return ALNSData(nr_customers, nr_nodes, nr_customers,
+		demand, service_times, start_window, end_window,
+		elevation_matrix, distance_matrix,
+		-1, nr_load_buckets, 140, 150);
+}
+
+/**
+Preprocessing micro benchmarks (VRPLDTT only)
+*/
+void run_preprocessing_benchmarks(ALNSData &data, int nr_repetitions, vector<BenchmarkResult> &results) {
+	int nr_arcs = data.nr_nodes * data.nr_nodes;
+
+	// resistance per kg of all arcs (as in get_slope_resistance, downhill arcs as flat)
+	vector<double> slope_resistances, velocities(nr_arcs);
+	for (const vector<double> &row : data.slope_matrix) {
+		for (double slope : row) {
+			double cos_slope = 1 / sqrt(1 + slope*slope);
+			slope_resistances.push_back(9.81 * (0.01 * cos_slope + max(slope, 0.0) * cos_slope));
+		}
+	}
+
+	double mass = data.vehicle_weight + data.vehicle_cap / 2.0;
+	results.push_back({ "velocity_calculation", get_ns_per_call(nr_repetitions * 10, [&]() {
+		velocity_calculation(mass, slope_resistances.data(), velocities.data(), nr_arcs, false);
+	}) });
+
+	results.push_back({ "get_time_cube", get_ns_per_call(max(nr_repetitions / 10, 1), [&]() {
+		TimeCube time_cube = get_time_cube(data.distance_matrix,
+			data.slope_matrix,
+			data.vehicle_weight,
+			data.vehicle_cap,
+			data.add_pseudo_capacity,
+			data.load_bucket_size,
+			false);
+	}) });
+
+	results.push_back({ "get_time_cube_compressed", get_ns_per_call(max(nr_repetitions / 10, 1), [&]() {
+		TimeCube time_cube = get_time_cube(data.distance_matrix,
+			data.slope_matrix,
+			data.vehicle_weight,
+			data.vehicle_cap,
+			data.add_pseudo_capacity,
+			data.load_bucket_size,
+			true);
+	}) });
+}
+
+/**
+Solution micro benchmarks (evaluate_change, get_best_insertion, operator=)
+*/
+void run_solution_benchmarks(ALNSData &data, const Solution &base_solution, double capa_error_weight, double frame_error_weight,
+	int nr_repetitions, vector<BenchmarkResult> &results)
+{
+	// 1) evaluate_change: removal and reinsertion in the middle of the longest route
+	Solution solution(data);
+	solution = base_solution;
+
+	int route_id = 0;
+	for (unsigned int rid = 0; rid < solution.solution_representation.size(); rid++) {
+		if (solution.solution_representation[rid].size() > solution.solution_representation[route_id].size()) {
+			route_id = rid;
+		}
+	}
+
+	vector<int> &route = solution.solution_representation[route_id];
+	int pos = int(route.size()) / 2;
+	results.push_back({ "evaluate_change", get_ns_per_call(nr_repetitions * 10, [&]() {
+		int customer_id = route[pos];
+		tools::remove_at(route, pos);
+		solution.evaluate_change(route_id, pos - 1, capa_error_weight, frame_error_weight);
+
+		route.insert(route.begin() + pos, customer_id);
+		solution.route_chromosome[customer_id] = route_id;
+		solution.evaluate_change(route_id, pos, capa_error_weight, frame_error_weight);
+	}) / 2 });
+
+	// 2) get_best_insertion of 10 removed customers
+	solution = base_solution;
+	vector<int> removed_customers;
+	for (int customer_id = 0; customer_id < data.nr_customer; customer_id += max(data.nr_customer / 10, 1)) {
+		int rid = solution.route_chromosome[customer_id];
+		vector<int> &customer_route = solution.solution_representation[rid];
+		int rem_pos = int(find(customer_route.begin(), customer_route.end(), customer_id) - customer_route.begin());
+
+		tools::remove_at(customer_route, rem_pos);
+		solution.evaluate_change(rid, rem_pos - 1, capa_error_weight, frame_error_weight);
+		removed_customers.push_back(customer_id);
+	}
+
+	double checksum = 0;
+	OperatorScratch scratch;
+	results.push_back({ "get_best_insertion", get_ns_per_call(nr_repetitions, [&]() {
+		for (int customer_id : removed_customers) {
+			checksum += get<0>(get_best_insertion(customer_id, solution, capa_error_weight, frame_error_weight, scratch, -1, true, true));
+		}
+	}) / removed_customers.size() });
+
+	// (without the lower bound pruning, see get_best_insertions)
+	results.push_back({ "get_best_insertion_unpruned", get_ns_per_call(nr_repetitions, [&]() {
+		for (int customer_id : removed_customers) {
+			checksum += get<0>(get_best_insertion(customer_id, solution, capa_error_weight, frame_error_weight, scratch, -1, true, false));
+		}
+	}) / removed_customers.size() });
+
+	// 3) Deep copy
+	Solution copy(data);
+	results.push_back({ "solution_copy", get_ns_per_call(nr_repetitions * 10, [&]() {
+		copy = base_solution;
+	}) });
+}
+
+/**
+Operator micro benchmarks (each call starts from the base solution, the copy is not timed)
+The repair operators reinsert the customers of a random destroy
+*/
+void run_operator_benchmarks(ALNS &alns, const Solution &base_solution, int nr_repetitions, vector<BenchmarkResult> &results) {
+	OperatorRegistry &registry = alns.operator_registry;
+	vector<int> removed_customers;
+
+	for (int op_id = 0; op_id < registry.nr_destroy_operators(); op_id++) {
+		int64_t time_ns = 0;
+		for (int repetition = 0; repetition < nr_repetitions; repetition++) {
+			alns.running_solution = base_solution;
+
+			StatsClock::time_point start = StatsClock::now();
+			registry.get_destroy_operator(op_id)(removed_customers);
+			time_ns += get_elapsed_ns(start);
+		}
+		results.push_back({ "destroy_" + registry.get_destroy_names()[op_id], double(time_ns) / nr_repetitions });
+	}
+
+	for (int op_id = 0; op_id < registry.nr_repair_operators(); op_id++) {
+		int64_t time_ns = 0;
+		for (int repetition = 0; repetition < nr_repetitions; repetition++) {
+			alns.running_solution = base_solution;
+			registry.get_destroy_operator(0)(removed_customers);
+
+			StatsClock::time_point start = StatsClock::now();
+			registry.get_repair_operator(op_id)(removed_customers);
+			time_ns += get_elapsed_ns(start);
+		}
+		results.push_back({ "repair_" + registry.get_repair_names()[op_id], double(time_ns) / nr_repetitions });
+	}
+}
+
+/**
+Construction heuristic micro benchmarks (plain heuristics, trial 0)
+*/
+void run_construction_benchmarks(ALNSData &data, int nr_repetitions, vector<BenchmarkResult> &results) {
+	tools::RandomGenerator random_generator(SEED);
+
+	for (construction::Heuristic heuristic : { construction::SAVINGS, construction::SOLOMON_I1, construction::SWEEP }) {
+		results.push_back({ "construction_" + construction::get_heuristic_name(heuristic), get_ns_per_call(max(nr_repetitions / 10, 1), [&]() {
+			vector<vector<int>> routes = construction::get_routes(data, heuristic, 0, random_generator);
+		}) });
+	}
+}
+
+/**
+Run the macro and micro benchmarks of one instance
+*/
+InstanceResult run_instance(const string &name, const string &problem_type, ALNSData &data, int nr_iterations, int nr_repetitions) {
+	InstanceResult result;
+	result.name = name;
+	result.problem_type = problem_type;
+	result.nr_customers = data.nr_customer;
+	result.nr_vehicles = data.nr_vehicles;
+	result.nr_buckets = data.time_cube.get_nr_buckets();
+
+	// 1) Macro: complete search
+	ALNS alns(data, DESTROY_OPERATORS, REPAIR_OPERATORS,
+		3600, nr_iterations, 0.001, 0.99975, 20, 0.1, 33, 13, 9, 9, 0, 1, 0.3, 0.2, 20, 2,
+		1, 1000, false, SEED);
+
+	StatsClock::time_point start = StatsClock::now();
+	alns.solve();
+	result.solve_time_ms = get_elapsed_ns(start) / 1e6;
+	result.value = alns.value;
+	result.iterations = alns.iterations;
+	result.stats = alns.stats;
+
+	// 2) Micro: on the final running solution (the best solution may not exist if never feasible)
+	Solution base_solution(data);
+	base_solution = alns.running_solution;
+
+	if (!data.slope_matrix.empty()) {
+		run_preprocessing_benchmarks(data, nr_repetitions, result.micro);
+	}
+	run_solution_benchmarks(data, base_solution, alns.capa_error_weight, alns.frame_error_weight, nr_repetitions, result.micro);
+	run_operator_benchmarks(alns, base_solution, nr_repetitions, result.micro);
+	run_construction_benchmarks(data, nr_repetitions, result.micro);
+
+	return result;
+}
+
+/**
+Utility function to write an integer array as JSON
+*/
+void write_json_array(FILE *file, const vector<int64_t> &values) {
+	fprintf(file, "[");
+	for (unsigned int i = 0; i < values.size(); i++) {
+		fprintf(file, "%s%lld", i > 0 ? ", " : "", (long long)values[i]);
+	}
+	fprintf(file, "]");
+}
+
+void write_json(const string &path, const vector<InstanceResult> &results, int nr_iterations, int nr_repetitions) {
+	FILE *file = fopen(path.c_str(), "w");
+	if (file == nullptr) {
+		fprintf(stderr, "Cannot write the result file: %s\n", path.c_str());
+		exit(1);
+	}
+
+	fprintf(file, "{\n\t\"seed\": %d,\n\t\"iterations\": %d,\n\t\"repetitions\": %d,\n\t\"instances\": [\n", SEED, nr_iterations, nr_repetitions);
+	for (unsigned int instance_id = 0; instance_id < results.size(); instance_id++) {
+		const InstanceResult &result = results[instance_id];
+		const SearchStats &stats = result.stats;
+
+		fprintf(file, "\t\t{\n\t\t\t\"name\": \"%s\",\n\t\t\t\"problem_type\": \"%s\",\n", result.name.c_str(), result.problem_type.c_str());
+		fprintf(file, "\t\t\t\"nr_customers\": %d,\n\t\t\t\"nr_vehicles\": %d,\n\t\t\t\"nr_buckets\": %d,\n",
+			result.nr_customers, result.nr_vehicles, result.nr_buckets);
+
+		// macro
+		// (value null: no feasible solution found)
+		fprintf(file, "\t\t\t\"solve\": {\n\t\t\t\t\"time_ms\": %.3f,\n", result.solve_time_ms);
+		if (result.value < numeric_limits<double>::max()) {
+			fprintf(file, "\t\t\t\t\"value\": %.6f,\n", result.value);
+		}
+		else {
+			fprintf(file, "\t\t\t\t\"value\": null,\n");
+		}
+		fprintf(file, "\t\t\t\t\"iterations\": %d,\n", result.iterations);
+		fprintf(file, "\t\t\t\t\"iteration_time_ns\": %lld,\n\t\t\t\t\"historic_update_time_ns\": %lld,\n",
+			(long long)stats.iteration_time_ns, (long long)stats.historic_update_time_ns);
+		fprintf(file, "\t\t\t\t\"visited_lookup_time_ns\": %lld,\n\t\t\t\t\"solution_copy_time_ns\": %lld,\n",
+			(long long)stats.visited_lookup_time_ns, (long long)stats.solution_copy_time_ns);
+		fprintf(file, "\t\t\t\t\"nr_evaluated_changes\": %lld,\n\t\t\t\t\"nr_rejected_changes\": %lld,\n",
+			(long long)stats.nr_evaluated_changes, (long long)stats.nr_rejected_changes);
+		fprintf(file, "\t\t\t\t\"destroy_calls\": ");
+		write_json_array(file, stats.destroy_calls);
+		fprintf(file, ",\n\t\t\t\t\"destroy_times_ns\": ");
+		write_json_array(file, stats.destroy_times_ns);
+		fprintf(file, ",\n\t\t\t\t\"insertion_calls\": ");
+		write_json_array(file, stats.insertion_calls);
+		fprintf(file, ",\n\t\t\t\t\"insertion_times_ns\": ");
+		write_json_array(file, stats.insertion_times_ns);
+		fprintf(file, "\n\t\t\t},\n");
+
+		// micro
+		fprintf(file, "\t\t\t\"micro_ns_per_call\": {\n");
+		for (unsigned int i = 0; i < result.micro.size(); i++) {
+			fprintf(file, "\t\t\t\t\"%s\": %.1f%s\n", result.micro[i].name.c_str(), result.micro[i].ns_per_call,
+				i + 1 < result.micro.size() ? "," : "");
+		}
+		fprintf(file, "\t\t\t}\n\t\t}%s\n", instance_id + 1 < results.size() ? "," : "");
+	}
+	fprintf(file, "\t]\n}\n");
+	fclose(file);
+}
+
+int main(int argc, char **argv) {
+	string json_path = argc > 1 ? argv[1] : "solver_benchmark.json";
+	int nr_iterations = argc > 2 ? atoi(argv[2]) : 2000;
+	int nr_repetitions = argc > 3 ? max(atoi(argv[3]), 1) : 100;
+
+	mt19937 random_generator(SEED);
+	ALNSData solomon_data = get_vrptw_data(100, 25, 200, 1000, random_generator);
+	ALNSData cordeau_data = get_vrptw_data(144, 20, 200, 1000, random_generator);
+	ALNSData fontaine_data = get_vrpldtt_data(20, 10, random_generator);
+
+	vector<InstanceResult> results;
+	results.push_back(run_instance("solomon_100", "VRPTW", solomon_data, nr_iterations, nr_repetitions));
+	results.push_back(run_instance("cordeau_144", "VRPTW", cordeau_data, nr_iterations, nr_repetitions));
+	results.push_back(run_instance("fontaine_20", "VRPLDTT", fontaine_data, nr_iterations, nr_repetitions));
+
+	write_json(json_path, results, nr_iterations, nr_repetitions);
+
+	for (const InstanceResult &result : results) {
+		printf("\n%s (%s, %d customers): solve %.1f ms, %d iterations, value %.3f%s\n",
+			result.name.c_str(), result.problem_type.c_str(), result.nr_customers,
+			result.solve_time_ms, result.iterations,
+			result.value < numeric_limits<double>::max() ? result.value : 0.0,
+			result.value < numeric_limits<double>::max() ? "" : " (no feasible solution)");
+		for (const BenchmarkResult &micro : result.micro) {
+			printf("%28s %14.1f ns\n", micro.name.c_str(), micro.ns_per_call);
+		}
+	}
+	printf("\nResults written to %s\n", json_path.c_str());
+	return 0;
+}
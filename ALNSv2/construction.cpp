@@ -0,0 +1,589 @@
+/**
+This file contains the construction heuristics of the initial solution (see construction.h)
+*/
+#include "construction.h"
+#include "evaluate.h"
+#include "tools.h"
+#include <vector>
+#include <string>
+#include <tuple>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+// Number of nearest customers per customer whose savings are considered (granular savings list)
+const int NR_SAVINGS_NEIGHBOURS = 40;
+
+const double PI = 3.14159265358979323846;
+
+construction::Heuristic construction::get_heuristic(const string &name) {
+	if (name == "random") {
+		return RANDOM;
+	}
+	else if (name == "savings") {
+		return SAVINGS;
+	}
+	else if (name == "solomon_i1") {
+		return SOLOMON_I1;
+	}
+	else if (name == "sweep") {
+		return SWEEP;
+	}
+	throw invalid_argument("Unknown construction heuristic: " + name + " (random, savings, solomon_i1 or sweep)");
+}
+
+string construction::get_heuristic_name(Heuristic heuristic) {
+	switch (heuristic) {
+	case SAVINGS:
+		return "savings";
+	case SOLOMON_I1:
+		return "solomon_i1";
+	case SWEEP:
+		return "sweep";
+	default:
+		return "random";
+	}
+}
+
+/**
+Travel time between two nodes of the empty vehicle (load 0 slice of the time cube)
+*/
+inline double get_empty_time(const ALNSData &data, int from, int to) {
+	return data.time_cube(0, from, to);
+}
+
+void construction::Route::evaluate(const ALNSData &data) {
+	const int r_size = this->customers.size();
+	this->loads.resize(r_size);
+	this->service_starts.resize(r_size);
+	this->prefix_driving_times.resize(r_size);
+
+	// 1) Loads (reverse)
+	double load = 0;
+	for (int route_pos = r_size - 1; route_pos >= 0; route_pos--) {
+		load += data.demand[this->customers[route_pos]];
+		this->loads[route_pos] = load;
+	}
+	this->is_feasible = (load <= data.vehicle_cap);
+
+	// 2) Visit times (see route_evaluate::get_starting_time / update_visit_times)
+	double current_time = 0;
+	int prev_node_id = 0;
+	this->driving_time = 0;
+
+	for (int route_pos = 0; route_pos < r_size; route_pos++) {
+		int customer_id = this->customers[route_pos];
+		int load_level = route_evaluate::get_load_bucket(this->loads[route_pos], data.load_bucket_size);
+		double ctoctime = data.time_cube(load_level, prev_node_id, customer_id + 1);
+
+		if (route_pos == 0) {
+			current_time = max(0.0, data.start_window[customer_id] - ctoctime);
+		}
+
+		current_time = max(current_time + ctoctime, data.start_window[customer_id]);
+		this->driving_time += ctoctime;
+		this->prefix_driving_times[route_pos] = this->driving_time;
+		this->service_starts[route_pos] = current_time;
+		this->is_feasible = this->is_feasible && (current_time <= data.end_window[customer_id]);
+
+		current_time += data.service_times[customer_id];
+		prev_node_id = customer_id + 1;
+	}
+
+	// 3) Back to the depot
+	double depot_time = (r_size > 0) ? data.time_cube(0, prev_node_id, 0) : 0;
+	this->driving_time += depot_time;
+	this->end_time = current_time + depot_time;
+}
+
+void construction::get_insertions(const ALNSData &data,
+	const Route &route,
+	const int customer_id,
+	vector<Insertion> &insertions)
+{
+	insertions.clear();
+
+	const vector<int> &customers = route.customers;
+	const int r_size = customers.size();
+	const double demand = data.demand[customer_id];
+
+	if (((r_size > 0) ? route.loads[0] + demand : demand) > data.vehicle_cap) {
+		return;
+	}
+
+	// shifted prefix: departure and driving time in front of the insertion position
+	// (all preceding customers carry the additional demand)
+	double prefix_time = 0;
+	double prefix_driving_time = 0;
+	int prev_node_id = 0;
+
+	for (int ins_pos = 0; ins_pos <= r_size; ins_pos++) {
+		// 1) Visit of the new customer
+		double customer_load = demand + ((ins_pos < r_size) ? route.loads[ins_pos] : 0);
+		int load_level = route_evaluate::get_load_bucket(customer_load, data.load_bucket_size);
+		double ctoctime = data.time_cube(load_level, prev_node_id, customer_id + 1);
+
+		double current_time = (ins_pos > 0) ? prefix_time : max(0.0, data.start_window[customer_id] - ctoctime);
+		current_time = max(current_time + ctoctime, data.start_window[customer_id]);
+
+		if (current_time <= data.end_window[customer_id]) {
+			double driving_time = prefix_driving_time + ctoctime;
+			double push_forward = 0;
+			bool is_feasible = true;
+			bool is_absorbed = false;
+			int from_node_id = customer_id + 1;
+			current_time += data.service_times[customer_id];
+
+			// 2) Succeeding customers (unchanged loads) until the delay is absorbed
+			for (int route_pos = ins_pos; route_pos < r_size; route_pos++) {
+				int route_customer_id = customers[route_pos];
+				int route_load_level = route_evaluate::get_load_bucket(route.loads[route_pos], data.load_bucket_size);
+				double next_time = data.time_cube(route_load_level, from_node_id, route_customer_id + 1);
+				double service_start = max(current_time + next_time, data.start_window[route_customer_id]);
+				driving_time += next_time;
+
+				if (route_pos == ins_pos) {
+					push_forward = service_start - route.service_starts[route_pos];
+				}
+
+				if (service_start == route.service_starts[route_pos]) {
+					// identical schedule from here on
+					driving_time += route.driving_time - route.prefix_driving_times[route_pos];
+					is_absorbed = true;
+					break;
+				}
+				else if (service_start > data.end_window[route_customer_id]) {
+					is_feasible = false;
+					break;
+				}
+
+				current_time = service_start + data.service_times[route_customer_id];
+				from_node_id = route_customer_id + 1;
+			}
+
+			if (is_feasible) {
+				if (!is_absorbed) {
+					double depot_time = data.time_cube(0, from_node_id, 0);
+					driving_time += depot_time;
+
+					if (ins_pos == r_size) {
+						push_forward = current_time + depot_time - route.end_time;
+					}
+				}
+				insertions.push_back({ ins_pos, driving_time, push_forward });
+			}
+		}
+
+		// 3) Extend the shifted prefix by the customer at the insertion position
+		if (ins_pos == r_size) {
+			break;
+		}
+
+		int route_customer_id = customers[ins_pos];
+		int route_load_level = route_evaluate::get_load_bucket(route.loads[ins_pos] + demand, data.load_bucket_size);
+		double route_time = data.time_cube(route_load_level, prev_node_id, route_customer_id + 1);
+
+		if (ins_pos == 0) {
+			prefix_time = max(0.0, data.start_window[route_customer_id] - route_time);
+		}
+
+		prefix_time = max(prefix_time + route_time, data.start_window[route_customer_id]);
+		if (prefix_time > data.end_window[route_customer_id]) {
+			// all later positions are infeasible as well
+			break;
+		}
+
+		prefix_time += data.service_times[route_customer_id];
+		prefix_driving_time += route_time;
+		prev_node_id = route_customer_id + 1;
+	}
+}
+
+/**
+Utility function to get exactly nr_vehicles routes (empty routes are added)
+*/
+vector<vector<int>> get_route_plan(const ALNSData &data, vector<vector<int>> routes) {
+	routes.resize(data.nr_vehicles);
+	return routes;
+}
+
+/**
+Utility function to insert a customer at its cheapest feasible position
+
+@return:	false if there is no feasible position (route not changed)
+*/
+bool insert_cheapest(const ALNSData &data,
+	construction::Route &route,
+	const int customer_id,
+	vector<construction::Insertion> &insertions)
+{
+	construction::get_insertions(data, route, customer_id, insertions);
+	if (insertions.empty()) {
+		return false;
+	}
+
+	vector<construction::Insertion>::const_iterator best = min_element(insertions.begin(), insertions.end(),
+		[](const construction::Insertion &a, const construction::Insertion &b) { return a.driving_time < b.driving_time; });
+
+	route.customers.insert(route.customers.begin() + best->route_pos, customer_id);
+	route.evaluate(data);
+	return true;
+}
+
+/**
+Parallel Clarke-Wright savings
+
+	1) Savings s(i, j) = t(i, 0) + t(0, j) - shape * t(i, j) of the empty vehicle (load 0 slice)
+	   for the NR_SAVINGS_NEIGHBOURS nearest customers j of each customer i
+	2) Start with one route per customer
+	3) Merge the route ending with i and the route starting with j (decreasing savings)
+	   if the merged route is feasible (directed: the time cube is asymmetric)
+	4) Keep the nr_vehicles routes with the highest load
+
+Randomized (trial > 0): shape in [0.5, 1.5] and a noise of +-10% on each saving
+*/
+vector<vector<int>> construction::savings_routes(const ALNSData &data, const int trial, tools::RandomGenerator &random_generator) {
+	const int nr_customers = data.nr_customer;
+	double shape = 1;
+	double noise = 0;
+
+	if (trial > 0) {
+		shape = 0.5 + random_generator.uniform();
+		noise = 0.2;
+	}
+
+	// 1) Savings of the nearest customers
+	const int nr_neighbours = min(nr_customers - 1, NR_SAVINGS_NEIGHBOURS);
+	vector<tuple<double, int, int>> savings; // saving, from customer (route end), to customer (route start)
+	savings.reserve(size_t(nr_customers)*max(nr_neighbours, 0));
+	vector<pair<double, int>> neighbours;
+
+	for (int from = 0; (from < nr_customers) && (nr_neighbours > 0); from++) {
+		neighbours.clear();
+		for (int to = 0; to < nr_customers; to++) {
+			if (to != from) {
+				neighbours.push_back(make_pair(get_empty_time(data, from + 1, to + 1), to));
+			}
+		}
+		nth_element(neighbours.begin(), neighbours.begin() + nr_neighbours, neighbours.end());
+
+		for (int neighbour = 0; neighbour < nr_neighbours; neighbour++) {
+			int to = neighbours[neighbour].second;
+			double saving = get_empty_time(data, from + 1, 0) + get_empty_time(data, 0, to + 1) - shape * neighbours[neighbour].first;
+			if (noise > 0) {
+				saving *= 1 + noise * (random_generator.uniform() - 0.5);
+			}
+			if (saving > 0) {
+				savings.push_back(make_tuple(saving, from, to));
+			}
+		}
+	}
+	sort(savings.begin(), savings.end(), greater<tuple<double, int, int>>());
+
+	// 2) One route per customer
+	vector<Route> routes(nr_customers);
+	vector<int> route_ids(nr_customers);
+
+	for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+		routes[customer_id].customers.push_back(customer_id);
+		routes[customer_id].evaluate(data);
+		route_ids[customer_id] = customer_id;
+	}
+
+	// 3) Merge the routes
+	Route merged;
+	for (const tuple<double, int, int> &saving : savings) {
+		int from = get<1>(saving);
+		int to = get<2>(saving);
+		Route &from_route = routes[route_ids[from]];
+		Route &to_route = routes[route_ids[to]];
+
+		if ((route_ids[from] == route_ids[to])
+			|| (from_route.customers.back() != from)
+			|| (to_route.customers.front() != to)
+			|| !from_route.is_feasible
+			|| !to_route.is_feasible
+			|| (from_route.loads[0] + to_route.loads[0] > data.vehicle_cap)) {
+			continue;
+		}
+
+		merged.customers = from_route.customers;
+		merged.customers.insert(merged.customers.end(), to_route.customers.begin(), to_route.customers.end());
+		merged.evaluate(data);
+
+		if (merged.is_feasible) {
+			for (int customer_id : to_route.customers) {
+				route_ids[customer_id] = route_ids[from];
+			}
+			to_route.customers.clear();
+			swap(from_route, merged);
+		}
+	}
+
+	// 4) Keep the routes with the highest load (customers that are infeasible alone are dropped)
+	vector<pair<double, int>> route_loads;
+	for (int route_id = 0; route_id < nr_customers; route_id++) {
+		if (!routes[route_id].customers.empty() && routes[route_id].is_feasible) {
+			route_loads.push_back(make_pair(-routes[route_id].loads[0], route_id));
+		}
+	}
+	sort(route_loads.begin(), route_loads.end());
+
+	vector<vector<int>> solution_rep;
+	for (unsigned int i = 0; (i < route_loads.size()) && (int(i) < data.nr_vehicles); i++) {
+		solution_rep.push_back(routes[route_loads[i].second].customers);
+	}
+	return get_route_plan(data, solution_rep);
+}
+
+/**
+Sequential Solomon I1 insertion
+
+Each route starts with a seed customer (farthest from the depot or earliest deadline).
+Then the customer u with the max c2 is inserted at its position with the min c1 until no customer fits:
+	c1(i, u, j) = alpha1 * (t(i, u) + t(u, j) - mu * t(i, j)) + (1 - alpha1) * push forward of j
+	c2(u) = lambda * t(0, u) - c1
+(t: empty vehicle, the push forward is the delay of the service at j with the exact times)
+
+Parameter sets (mu, lambda, alpha1) of Solomon (1987): (1, 1, 1), (1, 2, 1), (1, 1, 0), (1, 2, 0)
+	trial 0-3: sets with the farthest seed, trial 4-7: sets with the earliest deadline seed,
+	trial >= 8: random parameters (mu in [0.5, 1.5], lambda in [1, 2], alpha1 in [0, 1]) and seed criterion
+*/
+vector<vector<int>> construction::solomon_i1_routes(const ALNSData &data, const int trial, tools::RandomGenerator &random_generator) {
+	const double parameter_sets[4][3] = { { 1, 1, 1 }, { 1, 2, 1 }, { 1, 1, 0 }, { 1, 2, 0 } };
+	const int nr_customers = data.nr_customer;
+
+	double mu, lambda, alpha1;
+	bool earliest_deadline_seed;
+
+	if (trial < 8) {
+		mu = parameter_sets[trial % 4][0];
+		lambda = parameter_sets[trial % 4][1];
+		alpha1 = parameter_sets[trial % 4][2];
+		earliest_deadline_seed = (trial >= 4);
+	}
+	else {
+		mu = 0.5 + random_generator.uniform();
+		lambda = 1 + random_generator.uniform();
+		alpha1 = random_generator.uniform();
+		earliest_deadline_seed = (random_generator() & 1) == 1;
+	}
+
+	vector<bool> is_unrouted(nr_customers, true);
+	int nr_unrouted = nr_customers;
+	vector<vector<int>> solution_rep;
+	vector<Insertion> insertions;
+	Route route;
+
+	while ((nr_unrouted > 0) && (int(solution_rep.size()) < data.nr_vehicles)) {
+		// 1) Seed customer
+		int seed_id = -1;
+		double seed_value = -numeric_limits<double>::max();
+
+		for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+			double value = earliest_deadline_seed ? -data.end_window[customer_id] : get_empty_time(data, 0, customer_id + 1);
+			if (is_unrouted[customer_id] && (value > seed_value)) {
+				seed_id = customer_id;
+				seed_value = value;
+			}
+		}
+
+		is_unrouted[seed_id] = false;
+		nr_unrouted--;
+
+		route.customers.assign(1, seed_id);
+		route.evaluate(data);
+		if (!route.is_feasible) {
+			// infeasible alone -> not planned (no vehicle is used)
+			continue;
+		}
+
+		// 2) Insert the customer with the max c2 at its min c1 position
+		while (nr_unrouted > 0) {
+			int best_customer_id = -1;
+			int best_route_pos = -1;
+			double best_c2 = -numeric_limits<double>::max();
+
+			for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+				if (!is_unrouted[customer_id]) {
+					continue;
+				}
+
+				get_insertions(data, route, customer_id, insertions);
+
+				int route_pos = -1;
+				double min_c1 = numeric_limits<double>::max();
+				for (const Insertion &insertion : insertions) {
+					int prev_node_id = (insertion.route_pos > 0) ? route.customers[insertion.route_pos - 1] + 1 : 0;
+					int next_node_id = (insertion.route_pos < int(route.customers.size())) ? route.customers[insertion.route_pos] + 1 : 0;
+
+					double c11 = get_empty_time(data, prev_node_id, customer_id + 1) + get_empty_time(data, customer_id + 1, next_node_id)
+						- mu * get_empty_time(data, prev_node_id, next_node_id);
+					double c1 = alpha1 * c11 + (1 - alpha1) * insertion.push_forward;
+
+					if (c1 < min_c1) {
+						min_c1 = c1;
+						route_pos = insertion.route_pos;
+					}
+				}
+
+				if (route_pos >= 0) {
+					double c2 = lambda * get_empty_time(data, 0, customer_id + 1) - min_c1;
+					if (c2 > best_c2) {
+						best_c2 = c2;
+						best_customer_id = customer_id;
+						best_route_pos = route_pos;
+					}
+				}
+			}
+
+			if (best_customer_id < 0) {
+				break;
+			}
+
+			route.customers.insert(route.customers.begin() + best_route_pos, best_customer_id);
+			route.evaluate(data);
+			is_unrouted[best_customer_id] = false;
+			nr_unrouted--;
+		}
+		solution_rep.push_back(route.customers);
+	}
+	return get_route_plan(data, solution_rep);
+}
+
+/**
+Polar angles of the customers around the depot in [0, 2 pi)
+
+The data has no coordinates -> the angles are recovered from the (symmetrized) distances:
+	1) angle to the farthest customer a by the law of cosines (depot, a, customer)
+	2) sign by the distance to a second reference customer b (angle closest to pi / 2)
+*/
+vector<double> get_polar_angles(const ALNSData &data) {
+	const int nr_customers = data.nr_customer;
+	vector<double> angles(nr_customers, 0);
+
+	if (nr_customers < 2) {
+		return angles;
+	}
+
+	auto get_symmetric_distance = [&data](int from, int to) {
+		return 0.5 * (data.get_distance(from, to) + data.get_distance(to, from));
+	};
+
+	vector<double> radii(nr_customers);
+	for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+		radii[customer_id] = get_symmetric_distance(0, customer_id + 1);
+	}
+
+	// 1) Angle to the farthest customer (reference a)
+	int reference_a = int(max_element(radii.begin(), radii.end()) - radii.begin());
+	if (radii[reference_a] <= 0) {
+		return angles;
+	}
+
+	for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+		if (radii[customer_id] > 0) {
+			double distance = get_symmetric_distance(customer_id + 1, reference_a + 1);
+			double cos_angle = (radii[customer_id] * radii[customer_id] + radii[reference_a] * radii[reference_a] - distance * distance)
+				/ (2 * radii[customer_id] * radii[reference_a]);
+			angles[customer_id] = acos(max(-1.0, min(1.0, cos_angle)));
+		}
+	}
+
+	// 2) Sign by the second reference customer b (placed at the positive side)
+	int reference_b = -1;
+	for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+		if ((radii[customer_id] > 0) && ((reference_b < 0) || (abs(angles[customer_id] - PI / 2) < abs(angles[reference_b] - PI / 2)))) {
+			reference_b = customer_id;
+		}
+	}
+
+	double x_b = radii[reference_b] * cos(angles[reference_b]);
+	double y_b = radii[reference_b] * sin(angles[reference_b]);
+
+	for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+		double x = radii[customer_id] * cos(angles[customer_id]);
+		double y = radii[customer_id] * sin(angles[customer_id]);
+		double distance = get_symmetric_distance(customer_id + 1, reference_b + 1);
+
+		double positive_error = abs(hypot(x - x_b, y - y_b) - distance);
+		double negative_error = abs(hypot(x - x_b, -y - y_b) - distance);
+		if (negative_error < positive_error) {
+			angles[customer_id] = 2 * PI - angles[customer_id];
+		}
+	}
+	return angles;
+}
+
+/**
+Sweep
+
+The customers are visited by their polar angle around the depot. Each customer is inserted at the
+cheapest feasible position of the open route. If it does not fit, a new route is opened
+(if all vehicles are used, only the open route is tried).
+
+Randomized (trial > 0): random start angle and direction
+*/
+vector<vector<int>> construction::sweep_routes(const ALNSData &data, const int trial, tools::RandomGenerator &random_generator) {
+	const int nr_customers = data.nr_customer;
+	vector<double> angles = get_polar_angles(data);
+
+	double start_angle = 0;
+	double direction = 1;
+	if (trial > 0) {
+		start_angle = 2 * PI * random_generator.uniform();
+		direction = ((random_generator() & 1) == 1) ? 1 : -1;
+	}
+
+	// 1) Sweep order
+	vector<pair<double, int>> order;
+	for (int customer_id = 0; customer_id < nr_customers; customer_id++) {
+		double angle = fmod(direction * (angles[customer_id] - start_angle) + 4 * PI, 2 * PI);
+		order.push_back(make_pair(angle, customer_id));
+	}
+	sort(order.begin(), order.end());
+
+	// 2) Fill the routes
+	vector<vector<int>> solution_rep;
+	vector<Insertion> insertions;
+	Route route;
+
+	for (const pair<double, int> &customer : order) {
+		if (insert_cheapest(data, route, customer.second, insertions)) {
+			continue;
+		}
+
+		// open a new route (the customer is not planned if it does not fit there either)
+		if (!route.customers.empty() && (int(solution_rep.size()) + 1 < data.nr_vehicles)) {
+			solution_rep.push_back(route.customers);
+			route = Route();
+			insert_cheapest(data, route, customer.second, insertions);
+		}
+	}
+
+	if (!route.customers.empty()) {
+		solution_rep.push_back(route.customers);
+	}
+	return get_route_plan(data, solution_rep);
+}
+
+vector<vector<int>> construction::get_routes(const ALNSData &data,
+	const Heuristic heuristic,
+	const int trial,
+	tools::RandomGenerator &random_generator)
+{
+	switch (heuristic) {
+	case SAVINGS:
+		return savings_routes(data, trial, random_generator);
+	case SOLOMON_I1:
+		return solomon_i1_routes(data, trial, random_generator);
+	case SWEEP:
+		return sweep_routes(data, trial, random_generator);
+	default:
+		throw invalid_argument("The random initialization has no construction routes (see route_init_random)");
+	}
+}
@@ -0,0 +1,84 @@
+/**
+Construction heuristics of the initial solution (see ALNS::set_construction_heuristic)
+
+	RANDOM:		random vehicles in random order (capacity only, see route_init_random)
+	SAVINGS:	parallel Clarke-Wright savings on the load 0 slice of the time cube
+	SOLOMON_I1:	sequential Solomon I1 insertion with time windows
+	SWEEP:		sweep by the polar angle around the depot, cheapest insertion into the open route
+
+The routes are built with the exact load dependent travel times and are always feasible
+(capacity and time windows). Customers that fit into no route within nr_vehicles routes
+are not planned (they are inserted by the greedy insertion afterwards, see ALNS::initialization).
+
+Randomized variants:
+	Trial 0 is the plain heuristic. The following trials perturb it with their own generator
+	(savings: shape parameter and noise, I1: parameter sets and seed criterion, sweep: start angle)
+	-> independent trials, the best start is kept.
+*/
+#pragma once
+#include "alns_data.h"
+#include "tools.h"
+#include <vector>
+#include <string>
+
+namespace construction {
+	enum Heuristic {
+		RANDOM = 0,
+		SAVINGS = 1,
+		SOLOMON_I1 = 2,
+		SWEEP = 3
+	};
+
+	// "random", "savings", "solomon_i1" or "sweep" (throws std::invalid_argument)
+	Heuristic get_heuristic(const std::string &name);
+	std::string get_heuristic_name(Heuristic heuristic);
+
+	/**
+	Route of a construction heuristic (position based visit schedule)
+	The schedule matches the evaluation of the Solution (start at the first time window, waiting allowed).
+	*/
+	struct Route {
+		std::vector<int> customers;
+		std::vector<double> loads;					// Load carried to the customer (its and all succeeding demands)
+		std::vector<double> service_starts;			// Start of the service (max of arrival and start window)
+		std::vector<double> prefix_driving_times;	// Driving time up to the arrival at the customer
+		double driving_time = 0;					// Including the way back to the depot
+		double end_time = 0;						// Arrival at the depot
+		bool is_feasible = true;
+
+		// Evaluate the complete route (sets all attributes)
+		void evaluate(const ALNSData &data);
+	};
+
+	// Feasible insertion of a customer into a route (see get_insertions)
+	struct Insertion {
+		int route_pos;
+		double driving_time;		// Driving time of the route after the insertion
+		double push_forward;		// Delay of the successor (service start, depot: arrival)
+	};
+
+	/**
+	All feasible insertion positions of [customer_id] into [route] (route must be feasible)
+	The shifted prefix is computed once, the suffix is only propagated until the delay is absorbed.
+	*/
+	void get_insertions(const ALNSData &data,
+		const Route &route,
+		const int customer_id,
+		std::vector<Insertion> &insertions);
+
+	/**
+	Build the routes of a heuristic (one trial)
+
+	@param heuristic:	SAVINGS, SOLOMON_I1 or SWEEP (RANDOM throws, see route_init_random)
+	@param trial:		0 -> plain heuristic, > 0 -> randomized by the generator
+	@return:			nr_vehicles routes (customer ids), unplanned customers are missing
+	*/
+	std::vector<std::vector<int>> get_routes(const ALNSData &data,
+		const Heuristic heuristic,
+		const int trial,
+		tools::RandomGenerator &random_generator);
+
+	std::vector<std::vector<int>> savings_routes(const ALNSData &data, const int trial, tools::RandomGenerator &random_generator);
+	std::vector<std::vector<int>> solomon_i1_routes(const ALNSData &data, const int trial, tools::RandomGenerator &random_generator);
+	std::vector<std::vector<int>> sweep_routes(const ALNSData &data, const int trial, tools::RandomGenerator &random_generator);
+}
@@ -0,0 +1,297 @@
+/**
+This file contains the binary data file of the ALNSData object
+
+Layout (version 2, native byte order, doubles):
+	1) Header:		Magic, version, byte order mark, scalar attributes (incl. the normalization bounds)
+	2) Sections:	Table of (offset, rows, cols) of all arrays below
+	3) Arrays:		Flat row major arrays, each aligned to 64 bytes
+
+The time cube is not copied on load but viewed in the memory mapped file.
+All processes that load the same file therefore share its pages.
+The normalization bounds are stored as well -> no preprocessing on load.
+
+Annotation:
+	Files of another version or byte order are rejected (save them again).
+	The candidate lists are not stored (set them again after loading).
+	Only dense time cubes can be saved (set_layout before saving a compressed cube).
+*/
+#include "alns_data.h"
+#include "mapped_file.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+const char DATA_FILE_MAGIC[8] = { 'A', 'L', 'N', 'S', 'D', 'A', 'T', 'A' };
+const uint32_t DATA_FILE_VERSION = 2; // 2: normalization bounds instead of the normalized matrices
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const uint64_t SECTION_ALIGNMENT = 64;
+
+enum DataFileSection {
+	DEMAND = 0,
+	SERVICE_TIMES,
+	START_WINDOW,
+	END_WINDOW,
+	DISTANCE_MATRIX,
+	SLOPE_MATRIX,
+	TIME_CUBE,
+	NR_SECTIONS
+};
+
+struct DataFileSectionInfo {
+	uint64_t offset;	// in bytes from the file start
+	uint64_t rows;
+	uint64_t cols;
+};
+
+struct DataFileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint64_t file_size;
+
+	int32_t nr_vehicles;
+	int32_t nr_nodes;
+	int32_t nr_customer;
+	int32_t vehicle_weight;
+	int32_t vehicle_cap;
+	int32_t add_pseudo_capacity;
+	int32_t nr_buckets;
+	int32_t time_cube_layout;
+	double load_bucket_size;
+	double min_distance;
+	double distance_range;
+	double start_window_range;
+	double end_window_range;
+	double demand_range;
+
+	DataFileSectionInfo sections[NR_SECTIONS];
+};
+
+/**
+Utility function to get the next aligned offset
+*/
+uint64_t align_offset(uint64_t offset) {
+	return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+/**
+Utility functions to write arrays and padding
+*/
+void write_padding(ofstream &file, uint64_t &position, uint64_t offset) {
+	static const char zeros[SECTION_ALIGNMENT] = {};
+	file.write(zeros, streamsize(offset - position));
+	position = offset;
+}
+
+void write_values(ofstream &file, uint64_t &position, const double *values, uint64_t nr_values) {
+	file.write(reinterpret_cast<const char*>(values), streamsize(nr_values * sizeof(double)));
+	position += nr_values * sizeof(double);
+}
+
+/**
+Utility function to get the rows of a section as vector
+*/
+vector<double> read_vector(const char *file_data, const DataFileSectionInfo &section) {
+	const double *values = reinterpret_cast<const double*>(file_data + section.offset);
+	return vector<double>(values, values + section.rows * section.cols);
+}
+
+vector<vector<double>> read_matrix(const char *file_data, const DataFileSectionInfo &section) {
+	const double *values = reinterpret_cast<const double*>(file_data + section.offset);
+	vector<vector<double>> matrix(size_t(section.rows));
+
+	for (uint64_t i = 0; i < section.rows; i++) {
+		matrix[i].assign(values + i * section.cols, values + (i + 1) * section.cols);
+	}
+	return matrix;
+}
+
+/**
+Save the data object as binary data file
+
+@param path:	File path (overwritten if existing)
+*/
+void ALNSData::save(const string &path) const {
+	if (this->time_cube.is_compressed()) {
+		throw runtime_error("Compressed time cubes cannot be saved (convert them to a dense layout first)");
+	}
+
+	// 1) Get the section table
+	DataFileHeader header = {};
+	memcpy(header.magic, DATA_FILE_MAGIC, sizeof(DATA_FILE_MAGIC));
+	header.version = DATA_FILE_VERSION;
+	header.byte_order = BYTE_ORDER_MARK;
+	header.nr_vehicles = this->nr_vehicles;
+	header.nr_nodes = this->nr_nodes;
+	header.nr_customer = this->nr_customer;
+	header.vehicle_weight = this->vehicle_weight;
+	header.vehicle_cap = this->vehicle_cap;
+	header.add_pseudo_capacity = this->add_pseudo_capacity;
+	header.nr_buckets = this->time_cube.get_nr_buckets();
+	header.time_cube_layout = int32_t(this->time_cube.get_layout());
+	header.load_bucket_size = this->load_bucket_size;
+	header.min_distance = this->min_distance;
+	header.distance_range = this->distance_range;
+	header.start_window_range = this->start_window_range;
+	header.end_window_range = this->end_window_range;
+	header.demand_range = this->demand_range;
+
+	const vector<double> *vectors[] = { &this->demand, &this->service_times, &this->start_window, &this->end_window };
+	const vector<vector<double>> *matrices[] = { &this->distance_matrix, &this->slope_matrix };
+
+	uint64_t offset = align_offset(sizeof(DataFileHeader));
+	int section_id = 0;
+
+	for (const vector<double> *v : vectors) {
+		header.sections[section_id] = { offset, 1, v->size() };
+		offset = align_offset(offset + v->size() * sizeof(double));
+		section_id++;
+	}
+
+	for (const vector<vector<double>> *m : matrices) {
+		uint64_t cols = m->empty() ? 0 : (*m)[0].size();
+		for (const vector<double> &row : *m) {
+			if (row.size() != cols) {
+				throw runtime_error("Only rectangular matrices can be saved");
+			}
+		}
+
+		header.sections[section_id] = { offset, m->size(), cols };
+		offset = align_offset(offset + m->size() * cols * sizeof(double));
+		section_id++;
+	}
+
+	uint64_t nr_arcs = uint64_t(this->time_cube.get_nr_nodes()) * this->time_cube.get_nr_nodes();
+	header.sections[TIME_CUBE] = { offset, uint64_t(this->time_cube.get_nr_buckets()), nr_arcs };
+	header.file_size = offset + this->time_cube.size() * sizeof(double);
+
+	// 2) Write the file
+	ofstream file(path, ios::binary | ios::trunc);
+	if (!file) {
+		throw runtime_error("Cannot write the data file: " + path);
+	}
+
+	uint64_t position = sizeof(DataFileHeader);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(DataFileHeader));
+
+	section_id = 0;
+	for (const vector<double> *v : vectors) {
+		write_padding(file, position, header.sections[section_id].offset);
+		write_values(file, position, v->data(), v->size());
+		section_id++;
+	}
+
+	for (const vector<vector<double>> *m : matrices) {
+		write_padding(file, position, header.sections[section_id].offset);
+		for (const vector<double> &row : *m) {
+			write_values(file, position, row.data(), row.size());
+		}
+		section_id++;
+	}
+
+	write_padding(file, position, header.sections[TIME_CUBE].offset);
+	write_values(file, position, this->time_cube.data(), this->time_cube.size());
+
+	if (!file) {
+		throw runtime_error("Cannot write the data file: " + path);
+	}
+}
+
+/**
+Load a data object from a binary data file
+
+The file is memory mapped. The time cube views the mapped file (read only)
+and keeps it mapped as long as the data object (or a copy of it) exists.
+All other attributes are copied.
+
+@param path:	File path of a file written by save
+*/
+ALNSData ALNSData::load_mmap(const string &path) {
+	shared_ptr<MappedFile> file = make_shared<MappedFile>(path);
+	const char *file_data = file->data();
+
+	// 1) Validate the header
+	if (file->size() < sizeof(DataFileHeader)) {
+		throw runtime_error("Invalid data file (too small): " + path);
+	}
+
+	DataFileHeader header;
+	memcpy(&header, file_data, sizeof(DataFileHeader));
+
+	if (memcmp(header.magic, DATA_FILE_MAGIC, sizeof(DATA_FILE_MAGIC)) != 0) {
+		throw runtime_error("Invalid data file (not an ALNSData file): " + path);
+	}
+	if (header.version != DATA_FILE_VERSION || header.byte_order != BYTE_ORDER_MARK) {
+		throw runtime_error("Invalid data file (other version or byte order): " + path);
+	}
+	if (header.file_size != file->size()) {
+		throw runtime_error("Invalid data file (truncated): " + path);
+	}
+
+	for (const DataFileSectionInfo &section : header.sections) {
+		uint64_t max_values = header.file_size / sizeof(double);
+
+		if (section.offset % SECTION_ALIGNMENT != 0
+			|| (section.rows > 0 && section.cols > max_values / section.rows)
+			|| section.offset + section.rows * section.cols * sizeof(double) > header.file_size) {
+			throw runtime_error("Invalid data file (corrupt section table): " + path);
+		}
+	}
+
+	for (int section_id = DEMAND; section_id <= END_WINDOW; section_id++) {
+		if (header.sections[section_id].rows * header.sections[section_id].cols != uint64_t(header.nr_customer)) {
+			throw runtime_error("Invalid data file (customer dimensions): " + path);
+		}
+	}
+
+	uint64_t nr_arcs = uint64_t(header.nr_nodes) * header.nr_nodes;
+	if (header.sections[TIME_CUBE].rows != uint64_t(header.nr_buckets) || header.sections[TIME_CUBE].cols != nr_arcs) {
+		throw runtime_error("Invalid data file (time cube dimensions): " + path);
+	}
+
+	// the matrices are optional (0 rows) or complete
+	for (int section_id = DISTANCE_MATRIX; section_id <= SLOPE_MATRIX; section_id++) {
+		const DataFileSectionInfo &section = header.sections[section_id];
+		if (section.rows > 0 && (section.rows != uint64_t(header.nr_nodes) || section.cols != uint64_t(header.nr_nodes))) {
+			throw runtime_error("Invalid data file (matrix dimensions): " + path);
+		}
+	}
+
+	// 2) Create the object
+	ALNSData data(header.nr_vehicles,
+		header.nr_nodes,
+		header.nr_customer,
+		header.vehicle_weight,
+		header.vehicle_cap);
+
+	data.add_pseudo_capacity = header.add_pseudo_capacity;
+	data.load_bucket_size = header.load_bucket_size;
+	data.min_distance = header.min_distance;
+	data.distance_range = header.distance_range;
+	data.start_window_range = header.start_window_range;
+	data.end_window_range = header.end_window_range;
+	data.demand_range = header.demand_range;
+
+	data.demand = read_vector(file_data, header.sections[DEMAND]);
+	data.service_times = read_vector(file_data, header.sections[SERVICE_TIMES]);
+	data.start_window = read_vector(file_data, header.sections[START_WINDOW]);
+	data.end_window = read_vector(file_data, header.sections[END_WINDOW]);
+
+	data.distance_matrix = read_matrix(file_data, header.sections[DISTANCE_MATRIX]);
+	data.slope_matrix = read_matrix(file_data, header.sections[SLOPE_MATRIX]);
+
+	data.time_cube = TimeCube::from_external(
+		reinterpret_cast<const double*>(file_data + header.sections[TIME_CUBE].offset),
+		header.nr_buckets,
+		header.nr_nodes,
+		TimeCube::Layout(header.time_cube_layout),
+		file);
+
+	return data;
+}
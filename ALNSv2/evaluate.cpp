@@ -13,6 +13,8 @@ Annotation:
 */
 #include "evaluate.h"
 #include "solution.h"
+#include <limits>
+#include <algorithm>
 
 using namespace std;
 
@@ -31,23 +33,22 @@ void route_evaluate::update_route_chromosome(
 	}
 }
 
-
-
 /**
-	Utility function to compute the load bucket / load level of a certain cummulated demand
-
-	Annotation: We assume that the upper bound of a load interval must also be included!
-
-	@param:	customer_demand	The total customer_demand that should be put into a bucket
+Update the route positions of all nodes from start_pos on
+(all succeeding customers of a changed position are shifted)
 */
-int get_load_bucket(double customer_demand, const double load_bucket_size) {
-	// obviously the index of the bucketing starts at 0 
-	// -> use floor
-	// min double difference! to include upper bound aswell!
-	return int((customer_demand - 0.3) / load_bucket_size);
+void route_evaluate::update_route_positions(
+	vector<int> &route_positions,
+	const vector<int> &route,
+	int start_pos)
+{
+	for (unsigned int route_pos = max(start_pos, 0); route_pos < route.size(); route_pos++) {
+		route_positions[route[route_pos]] = route_pos;
+	}
 }
 
 
+
 /**
 	Updates the load levels of an route till a certain position
 	We know that the start must always be the route start.
@@ -104,7 +105,7 @@ void route_evaluate::update_visit_times(
 	const vector<int> &route,
 	const vector<int> &load_levels,
 	const vector<double> &start_windows,
-	const vector<vector<vector<double>>> &time_cube,
+	const TimeCube &time_cube,
 	const vector<double> &service_times)
 {
 	route_driving_time = 0;
@@ -116,7 +117,7 @@ void route_evaluate::update_visit_times(
 		int node_id = customer_id+1;// +1 because of its node ids!
 
 		// update arrival time
-		double ctoctime = time_cube[load_levels[customer_id]][prev_node_id][node_id];
+		double ctoctime = time_cube(load_levels[customer_id], prev_node_id, node_id);
 		current_time += ctoctime;
 		route_driving_time += ctoctime;
 
@@ -134,7 +135,68 @@ void route_evaluate::update_visit_times(
 	}
 
 	// Finish to depot!
-	route_driving_time += time_cube[0][prev_node_id][0];
+	route_driving_time += time_cube(0, prev_node_id, 0);
+}
+
+/**
+	Updates the segment summaries of a route that allow to evaluate an insertion
+	without changing the route (see Solution::get_insertion_cost).
+	Must be called after update_visit_times.
+
+	Summaries (customer based):
+		1) prefix_driving_times:	Driving time from the depot up to the arrival at the customer
+		2) suffix_frame_errors:		Frame error of the customer and all succeeding customers
+		3) time_slacks:				Max delay of the arrival at the customer that does not
+									change the frame error of the remaining route
+
+	Annotation:
+		The slack is computed backwards. Waiting times in front of a customer
+		absorb delays, a customer that is already late absorbs nothing.
+*/
+void route_evaluate::update_route_segments(
+	vector<double> &prefix_driving_times,
+	vector<double> &suffix_frame_errors,
+	vector<double> &time_slacks,
+	const double starting_time,
+	const vector<int> &route,
+	const vector<int> &load_levels,
+	const vector<double> &arrival_times,
+	const vector<double> &departure_times,
+	const vector<double> &end_window,
+	const TimeCube &time_cube)
+{
+	// 1) Forward pass: cummulated driving times
+	double driving_time = 0;
+	int prev_node_id = 0;
+
+	for (unsigned int route_pos = 0; route_pos < route.size(); route_pos++) {
+		int customer_id = route[route_pos];
+		driving_time += time_cube(load_levels[customer_id], prev_node_id, customer_id + 1);
+		prefix_driving_times[customer_id] = driving_time;
+		prev_node_id = customer_id + 1;
+	}
+
+	// 2) Backward pass: frame errors and slacks
+	double frame_error = 0;
+	double next_slack = std::numeric_limits<double>::max();
+
+	for (int route_pos = int(route.size()) - 1; route_pos >= 0; route_pos--) {
+		int customer_id = route[route_pos];
+		double time_to_end = end_window[customer_id] - arrival_times[customer_id];
+
+		frame_error += max(0.0, -time_to_end);
+		suffix_frame_errors[customer_id] = frame_error;
+
+		double slack = min(max(0.0, time_to_end), next_slack);
+		time_slacks[customer_id] = slack;
+
+		// waiting time in front of this customer absorbs delays of the predecessor
+		double prev_departure = (route_pos > 0) ? departure_times[route[route_pos - 1]] : starting_time;
+		int prev_node = (route_pos > 0) ? route[route_pos - 1] + 1 : 0;
+		double waiting_time = arrival_times[customer_id] - (prev_departure + time_cube(load_levels[customer_id], prev_node, customer_id + 1));
+
+		next_slack = slack + max(0.0, waiting_time);
+	}
 }
 
 /**
@@ -145,14 +207,14 @@ double route_evaluate::get_starting_time(
 	vector<int> &route,
 	vector<int> &loads_levels,
 	const vector<double> &start_windows,
-	const vector<vector<vector<double>>> &time_cube) 
+	const TimeCube &time_cube) 
 {
 	if (route.size() > 0) {
 		int first_customer_id = route[0];
 
 		// We start the route the latest we have to
 		// Annotation: Depot -> first customer
-		double starting_time = start_windows[first_customer_id] - time_cube[loads_levels[first_customer_id]][0][first_customer_id + 1];
+		double starting_time = start_windows[first_customer_id] - time_cube(loads_levels[first_customer_id], 0, first_customer_id + 1);
 		return max(0.0, starting_time);
 	}
 	return 0.0;
@@ -180,11 +242,11 @@ double route_evaluate::get_total_time(
 	const vector<int> &route,
 	const double start_time,
 	const vector<double> &departure_times,
-	const vector<vector<vector<double>>> &time_cube)
+	const TimeCube &time_cube)
 {
 	if (route.size() > 0) {
 		int customer_id = route.back();
-		return (departure_times[customer_id] + time_cube[0][customer_id + 1][0]) - start_time; // last_customer + depot
+		return (departure_times[customer_id] + time_cube(0, customer_id + 1, 0)) - start_time; // last_customer + depot
 	}	
 	return 0;
 }
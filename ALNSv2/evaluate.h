@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include "solution.h"
+#include "time_cube.h"
 
 namespace route_evaluate {
 	// Finalize solution representation
@@ -10,6 +11,25 @@ namespace route_evaluate {
 		int route_id,
 		int start_pos=0);
 
+	// Update the route positions of all customers from start_pos on (customer -> position)
+	void update_route_positions(
+		std::vector<int> &route_positions,
+		const std::vector<int> &route,
+		int start_pos=0);
+
+	/**
+	Load bucket (load level) of a cummulated demand
+
+	Annotation: We assume that the upper bound of a load interval must also be included!
+	(inline -> the batch insertion loops stay vectorizable)
+	*/
+	inline int get_load_bucket(double customer_demand, const double load_bucket_size) {
+		// obviously the index of the bucketing starts at 0 
+		// -> use floor
+		// min double difference! to include upper bound aswell!
+		return int((customer_demand - 0.3) / load_bucket_size);
+	}
+
 	// ROUTE BASIS
 	// [[Start -> End]]
 	// The update functions take an object and update it
@@ -30,15 +50,27 @@ namespace route_evaluate {
 		const std::vector<int> &route,
 		const std::vector<int> &load_levels,
 		const std::vector<double> &start_window,
-		const std::vector<std::vector<std::vector<double>>> &time_cube,
+		const TimeCube &time_cube,
 		const std::vector<double> &service_times);
 
+	void update_route_segments(
+		std::vector<double> &prefix_driving_times,
+		std::vector<double> &suffix_frame_errors,
+		std::vector<double> &time_slacks,
+		const double starting_time,
+		const std::vector<int> &route,
+		const std::vector<int> &load_levels,
+		const std::vector<double> &arrival_times,
+		const std::vector<double> &departure_times,
+		const std::vector<double> &end_window,
+		const TimeCube &time_cube);
+
 	// [[Complete Route]]
 	double get_starting_time(
 		std::vector<int> &route,
 		std::vector<int> &load_levels,
 		const std::vector<double> &start_windows,
-		const std::vector<std::vector<std::vector<double>>> &time_cube);
+		const TimeCube &time_cube);
 
 	double get_quality(
 		const double time,
@@ -55,7 +87,7 @@ namespace route_evaluate {
 		const std::vector<int> &route,
 		const double start_time,
 		const std::vector<double> &departure_times,
-		const std::vector<std::vector<std::vector<double>>> &time_cube);
+		const TimeCube &time_cube);
 	*/
 
 	double get_capa_error(
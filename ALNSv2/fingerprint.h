@@ -0,0 +1,69 @@
+/**
+Compact 128 bit fingerprint of a solution (Zobrist style)
+
+Every arc (from, to) of the solution (depot = node 0, customer = customer_id + 1)
+owns a pseudo random key. The fingerprint of a route is the XOR of all its arc keys,
+the fingerprint of a solution is the XOR of all route fingerprints.
+
+Properties:
+	1) Route order independent (identical vehicles -> identical solutions)
+	2) A changed route only requires to XOR out its old and XOR in its new fingerprint
+	3) The keys are derived by a hash instead of a table (no memory per arc)
+
+Annotation:
+	Empty routes have no arcs and the fingerprint 0.
+	Each customer has exactly one successor so keys can never cancel out.
+*/
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct Fingerprint {
+	uint64_t lo = 0;
+	uint64_t hi = 0;
+
+	inline Fingerprint& operator^=(const Fingerprint &other) {
+		this->lo ^= other.lo;
+		this->hi ^= other.hi;
+		return *this;
+	}
+
+	inline bool operator==(const Fingerprint &other) const { return this->lo == other.lo && this->hi == other.hi; }
+	inline bool operator!=(const Fingerprint &other) const { return !(*this == other); }
+};
+
+namespace fingerprint {
+	// splitmix64 finalizer (bijective, good avalanche)
+	inline uint64_t mix(uint64_t x) {
+		x += 0x9e3779b97f4a7c15ULL;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+	// Key of the arc (from, to) in node ids
+	inline Fingerprint arc_key(int from, int to) {
+		uint64_t arc = (uint64_t(uint32_t(from)) << 32) | uint32_t(to);
+		Fingerprint key;
+		key.lo = mix(arc);
+		key.hi = mix(arc ^ 0x5851f42d4c957f2dULL);
+		return key;
+	}
+
+	// Fingerprint of a single route of customer ids (O(route size))
+	inline Fingerprint get_route_fingerprint(const std::vector<int> &route) {
+		Fingerprint route_fingerprint;
+		if (route.empty()) {
+			return route_fingerprint;
+		}
+
+		int prev_node = 0; // depot
+		for (int customer_id : route) {
+			route_fingerprint ^= arc_key(prev_node, customer_id + 1);
+			prev_node = customer_id + 1;
+		}
+		route_fingerprint ^= arc_key(prev_node, 0);
+		return route_fingerprint;
+	}
+}
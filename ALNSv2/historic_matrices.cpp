@@ -0,0 +1,242 @@
+/**
+This file contains the incremental historic node pair matrices (see historic_matrices.h)
+*/
+#include "historic_matrices.h"
+#include "solution.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+const uint32_t HistoricMatrices::NOT_PRESENT;
+
+HistoricMatrices::HistoricMatrices(int nr_nodes) :
+	nr_nodes(nr_nodes),
+	usage(size_t(nr_nodes)*nr_nodes, 0),
+	potential(size_t(nr_nodes)*nr_nodes, numeric_limits<float>::max()),
+	successor(nr_nodes, -1),
+	successor_since(nr_nodes, NOT_PRESENT),
+	depot_since(nr_nodes, NOT_PRESENT) {}
+
+/**
+Min driving time of all updates from [since] up to the last update
+*/
+double HistoricMatrices::get_min_driving_time(uint32_t since) const {
+	vector<pair<uint32_t, double>>::const_iterator it = lower_bound(this->suffix_minima.begin(),
+		this->suffix_minima.end(),
+		since,
+		[](const pair<uint32_t, double> &entry, uint32_t id) {return entry.first < id; });
+
+	return it == this->suffix_minima.end() ? numeric_limits<double>::max() : it->second;
+}
+
+/**
+First update of the edge if it is part of the last updated solution (else NOT_PRESENT)
+*/
+uint32_t HistoricMatrices::get_since(int from, int to) const {
+	if (from == 0) {
+		return (to > 0) ? this->depot_since[to] : NOT_PRESENT;
+	}
+	return (this->successor[from] == to) ? this->successor_since[from] : NOT_PRESENT;
+}
+
+/**
+Start the pending interval of an edge with the current update
+*/
+void HistoricMatrices::add_edge(int from, int to) {
+	size_t index = this->get_index(from, to);
+
+	if (from == 0) {
+		this->depot_since[to] = this->nr_updates;
+	}
+	else {
+		this->successor[from] = to;
+		this->successor_since[from] = this->nr_updates;
+	}
+
+	// part of all previous updates (e.g. only moved to another changed route)
+	if (this->usage[index] == this->nr_updates) {
+		this->nr_steady_edges++;
+	}
+	this->nr_edges++;
+}
+
+/**
+Resolve the pending interval [since, last update] of an edge
+Must be called before the driving time of the current update is logged!
+*/
+void HistoricMatrices::remove_edge(int from, int to) {
+	size_t index = this->get_index(from, to);
+	uint32_t since = this->get_since(from, to);
+
+	if (this->usage[index] == since) {
+		this->nr_steady_edges--;
+	}
+	this->usage[index] += this->nr_updates - since;
+	this->potential[index] = min(this->potential[index], float(this->get_min_driving_time(since)));
+
+	if (from == 0) {
+		this->depot_since[to] = NOT_PRESENT;
+	}
+	else {
+		this->successor[from] = -1;
+		this->successor_since[from] = NOT_PRESENT;
+	}
+	this->nr_edges--;
+}
+
+/**
+Log all edges of the solution
+
+	1) Identify the changed routes (route fingerprints)
+	2) Resolve the edges of their previous versions
+	3) Log the driving time of the solution
+	4) Start the edges of their new versions
+
+All edges of unchanged routes stay pending -> O(changed routes) instead of O(n)
+*/
+void HistoricMatrices::update(const Solution &solution) {
+	const vector<vector<int>> &new_routes = solution.solution_representation;
+
+	// (first update: all non empty routes differ from the empty fingerprint)
+	if (this->routes.size() != new_routes.size()) {
+		this->routes.resize(new_routes.size());
+		this->route_fingerprints.resize(new_routes.size());
+	}
+
+	// 1) + 2) Resolve the edges of all changed routes first
+	// (customers may have moved between changed routes)
+	for (unsigned int route_id = 0; route_id < new_routes.size(); route_id++) {
+		if (solution.route_fingerprints[route_id] == this->route_fingerprints[route_id]) {
+			continue;
+		}
+
+		const vector<int> &route = this->routes[route_id];
+		if (route.size() > 0) {
+			int prev_node_id = 0;
+			for (int customer_id : route) {
+				this->remove_edge(prev_node_id, customer_id + 1);
+				prev_node_id = customer_id + 1;
+			}
+			this->remove_edge(prev_node_id, 0);
+		}
+	}
+
+	// 3) Log the driving time (only the suffix minima are relevant)
+	double driving_time = solution.driving_time;
+	while (!this->suffix_minima.empty() && this->suffix_minima.back().second >= driving_time) {
+		this->suffix_minima.pop_back();
+	}
+	this->suffix_minima.push_back(make_pair(this->nr_updates, driving_time));
+
+	// 4) Start the edges of the new routes
+	for (unsigned int route_id = 0; route_id < new_routes.size(); route_id++) {
+		if (solution.route_fingerprints[route_id] == this->route_fingerprints[route_id]) {
+			continue;
+		}
+
+		const vector<int> &route = new_routes[route_id];
+		if (route.size() > 0) {
+			int prev_node_id = 0;
+			for (int customer_id : route) {
+				this->add_edge(prev_node_id, customer_id + 1);
+				prev_node_id = customer_id + 1;
+			}
+			this->add_edge(prev_node_id, 0);
+		}
+
+		this->routes[route_id] = route;
+		this->route_fingerprints[route_id] = solution.route_fingerprints[route_id];
+	}
+
+	this->nr_updates++;
+}
+
+double HistoricMatrices::get_potential(int from, int to) const {
+	float value = this->potential[this->get_index(from, to)];
+	uint32_t since = this->get_since(from, to);
+
+	if (since != NOT_PRESENT) {
+		value = min(value, float(this->get_min_driving_time(since)));
+	}
+	return value;
+}
+
+uint32_t HistoricMatrices::get_usage(int from, int to) const {
+	uint32_t value = this->usage[this->get_index(from, to)];
+	uint32_t since = this->get_since(from, to);
+
+	if (since != NOT_PRESENT) {
+		value += this->nr_updates - since;
+	}
+	if (!this->prior_usage.empty()) {
+		value += this->prior_usage[this->get_index(from, to)];
+	}
+	return value;
+}
+
+double HistoricMatrices::get_diversity() const {
+	if (this->nr_edges == 0) {
+		return 0;
+	}
+	return double(this->nr_edges - this->nr_steady_edges) / this->nr_edges;
+}
+
+vector<float> HistoricMatrices::get_potential_matrix() const {
+	vector<float> matrix(this->potential.size());
+
+	for (int from = 0; from < this->nr_nodes; from++) {
+		for (int to = 0; to < this->nr_nodes; to++) {
+			matrix[this->get_index(from, to)] = float(this->get_potential(from, to));
+		}
+	}
+	return matrix;
+}
+
+vector<uint32_t> HistoricMatrices::get_usage_matrix() const {
+	vector<uint32_t> matrix(this->usage.size());
+
+	for (int from = 0; from < this->nr_nodes; from++) {
+		for (int to = 0; to < this->nr_nodes; to++) {
+			matrix[this->get_index(from, to)] = this->get_usage(from, to);
+		}
+	}
+	return matrix;
+}
+
+void HistoricMatrices::set_prior(const vector<float> &prior_potential, const vector<uint32_t> &prior_usage) {
+	size_t nr_pairs = size_t(this->nr_nodes)*this->nr_nodes;
+	if ((!prior_potential.empty() && prior_potential.size() != nr_pairs) || (!prior_usage.empty() && prior_usage.size() != nr_pairs)) {
+		throw invalid_argument("The historic matrices must be of dimension nr_nodes x nr_nodes");
+	}
+
+	// (the pending intervals only lower the potentials further)
+	for (size_t index = 0; index < prior_potential.size(); index++) {
+		this->potential[index] = min(this->potential[index], prior_potential[index]);
+	}
+	this->prior_usage = prior_usage;
+}
+
+void HistoricMatrices::merge_potentials(vector<float> &shared_potential) {
+	// 1) Resolve the pending potentials of the current edges
+	// (the pending interval stays open, its min is already included)
+	for (int node_id = 1; node_id < this->nr_nodes; node_id++) {
+		if (this->successor[node_id] >= 0) {
+			size_t index = this->get_index(node_id, this->successor[node_id]);
+			this->potential[index] = float(this->get_potential(node_id, this->successor[node_id]));
+		}
+		if (this->depot_since[node_id] != NOT_PRESENT) {
+			size_t index = this->get_index(0, node_id);
+			this->potential[index] = float(this->get_potential(0, node_id));
+		}
+	}
+
+	// 2) Merge
+	for (size_t index = 0; index < this->potential.size(); index++) {
+		float value = min(shared_potential[index], this->potential[index]);
+		shared_potential[index] = value;
+		this->potential[index] = value;
+	}
+}
@@ -0,0 +1,87 @@
+/**
+Historic node pair information of all running solutions of the search
+(node based: node = customer + 1, depot = 0)
+
+	1) Usage:		Number of updates (iterations) the edge was part of the running solution
+	2) Potential:	Best (min) driving time of all running solutions containing the edge
+
+Both are updated incrementally. Only the edges of routes that changed since the
+last update are touched (detected by the route fingerprints of the solution).
+An edge that stays in the solution keeps a pending interval [since, last update]
+that is resolved on access:
+	usage:		stored usage + length of the interval
+	potential:	min(stored potential, min driving time of the interval (suffix minima))
+
+The matrices are stored flat ([from*nr_nodes + to]) with compact value types.
+*/
+#pragma once
+#include "solution.h"
+#include "fingerprint.h"
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+class HistoricMatrices {
+private:
+	static const std::uint32_t NOT_PRESENT = 0xFFFFFFFF;
+
+	int nr_nodes = 0;
+	std::uint32_t nr_updates = 0;
+
+	// resolved part of the matrices (without the pending intervals)
+	std::vector<std::uint32_t> usage;
+	std::vector<float> potential;
+	std::vector<std::uint32_t> prior_usage; // usages of a previous search (empty if not set, see set_prior)
+
+	// edges of the last updated solution (each customer has exactly one successor)
+	std::vector<int> successor;					// node -> successor node (-1: not present)
+	std::vector<std::uint32_t> successor_since;	// node -> first update of the edge (node, successor)
+	std::vector<std::uint32_t> depot_since;		// node -> first update of the edge (depot, node) (NOT_PRESENT)
+	std::vector<std::vector<int>> routes;		// routes of the last updated solution
+	std::vector<Fingerprint> route_fingerprints;
+
+	// suffix minima of the driving times over all updates (update id, driving time)
+	// -> min driving time of the updates [since, last update] is the first entry with id >= since
+	std::vector<std::pair<std::uint32_t, double>> suffix_minima;
+
+	int nr_edges = 0;
+	int nr_steady_edges = 0; // edges that were part of all updates
+
+	std::size_t get_index(int from, int to) const { return std::size_t(from)*this->nr_nodes + to; }
+	double get_min_driving_time(std::uint32_t since) const;
+	std::uint32_t get_since(int from, int to) const;
+
+	void add_edge(int from, int to);
+	void remove_edge(int from, int to);
+
+public:
+	HistoricMatrices() {};
+	HistoricMatrices(int nr_nodes);
+
+	// Log the edges of the solution (touches only the changed routes)
+	void update(const Solution &solution);
+
+	// Resolved values (including the pending interval of the current edges)
+	double get_potential(int from, int to) const;
+	std::uint32_t get_usage(int from, int to) const;
+
+	/**
+	Diversity of the last updated solution: share of its edges that were
+	not part of all previous updates (0: only steady edges, 1: only new edges)
+	*/
+	double get_diversity() const;
+
+	// Merge (min) the potentials with a shared flat matrix (island model)
+	void merge_potentials(std::vector<float> &shared_potential);
+
+	// Resolved matrices, flat [from*nr_nodes + to] (e.g. to seed the next search)
+	std::vector<float> get_potential_matrix() const;
+	std::vector<std::uint32_t> get_usage_matrix() const;
+
+	/**
+	Knowledge of a previous search (flat, empty: not set)
+	The potentials are merged (min), the usages are added to the own usages.
+	The diversity only considers the own updates.
+	*/
+	void set_prior(const std::vector<float> &prior_potential, const std::vector<std::uint32_t> &prior_usage);
+};
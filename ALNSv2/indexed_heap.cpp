@@ -0,0 +1,99 @@
+/**
+This file contains the indexed binary heap (see indexed_heap.h)
+*/
+#include "indexed_heap.h"
+#include <vector>
+
+using namespace std;
+
+IndexedHeap::IndexedHeap(int nr_ids) :
+	positions(nr_ids, -1),
+	keys(nr_ids, 0) {
+	this->heap.reserve(nr_ids);
+}
+
+void IndexedHeap::reset(int nr_ids) {
+	this->heap.clear();
+	this->positions.assign(nr_ids, -1);
+	this->keys.assign(nr_ids, 0);
+}
+
+bool IndexedHeap::has_priority(int id, int other_id) const {
+	if (this->keys[id] != this->keys[other_id]) {
+		return this->keys[id] > this->keys[other_id];
+	}
+	return id < other_id;
+}
+
+void IndexedHeap::swap_at(int heap_pos, int other_heap_pos) {
+	int id = this->heap[heap_pos];
+	int other_id = this->heap[other_heap_pos];
+
+	this->heap[heap_pos] = other_id;
+	this->heap[other_heap_pos] = id;
+	this->positions[other_id] = heap_pos;
+	this->positions[id] = other_heap_pos;
+}
+
+void IndexedHeap::sift_up(int heap_pos) {
+	while (heap_pos > 0) {
+		int parent_pos = (heap_pos - 1) / 2;
+		if (!this->has_priority(this->heap[heap_pos], this->heap[parent_pos])) {
+			break;
+		}
+		this->swap_at(heap_pos, parent_pos);
+		heap_pos = parent_pos;
+	}
+}
+
+void IndexedHeap::sift_down(int heap_pos) {
+	int heap_size = this->size();
+
+	while (true) {
+		int best_pos = heap_pos;
+		int left_pos = 2 * heap_pos + 1;
+		int right_pos = left_pos + 1;
+
+		if ((left_pos < heap_size) && this->has_priority(this->heap[left_pos], this->heap[best_pos])) {
+			best_pos = left_pos;
+		}
+		if ((right_pos < heap_size) && this->has_priority(this->heap[right_pos], this->heap[best_pos])) {
+			best_pos = right_pos;
+		}
+		if (best_pos == heap_pos) {
+			break;
+		}
+		this->swap_at(heap_pos, best_pos);
+		heap_pos = best_pos;
+	}
+}
+
+void IndexedHeap::set(int id, double key) {
+	this->keys[id] = key;
+
+	if (this->positions[id] < 0) {
+		this->positions[id] = this->size();
+		this->heap.push_back(id);
+	}
+
+	// only one of both moves the id
+	this->sift_up(this->positions[id]);
+	this->sift_down(this->positions[id]);
+}
+
+void IndexedHeap::remove(int id) {
+	int heap_pos = this->positions[id];
+	if (heap_pos < 0) {
+		return;
+	}
+
+	int last_pos = this->size() - 1;
+	this->swap_at(heap_pos, last_pos);
+	this->heap.pop_back();
+	this->positions[id] = -1;
+
+	if (heap_pos < last_pos) {
+		this->sift_up(heap_pos);
+		this->sift_down(heap_pos);
+	}
+}
@@ -0,0 +1,43 @@
+/**
+Indexed binary max heap over the ids [0, nr_ids) with a double key per id
+
+The position of each id in the heap is known -> the key of any id can be
+changed (or the id removed) in O(log n) instead of rebuilding the heap.
+
+Annotation:
+	Ties are resolved by the smaller id (same order as a scan over the ids
+	with a strict comparison). For a min heap push the negated keys.
+*/
+#pragma once
+#include <vector>
+
+class IndexedHeap {
+private:
+	std::vector<int> heap;			// heap position -> id
+	std::vector<int> positions;		// id -> heap position (-1 -> not contained)
+	std::vector<double> keys;		// id based
+
+	bool has_priority(int id, int other_id) const;
+	void sift_up(int heap_pos);
+	void sift_down(int heap_pos);
+	void swap_at(int heap_pos, int other_heap_pos);
+
+public:
+	explicit IndexedHeap(int nr_ids = 0);
+
+	// Remove all ids and set the id range to [0, nr_ids) (keeps the allocated memory)
+	void reset(int nr_ids);
+
+	// Insert the id or change its key
+	void set(int id, double key);
+	void remove(int id);
+
+	bool contains(int id) const { return this->positions[id] >= 0; }
+	double get_key(int id) const { return this->keys[id]; }
+
+	// Id with the max key (heap must not be empty)
+	int top() const { return this->heap[0]; }
+
+	int size() const { return int(this->heap.size()); }
+	bool empty() const { return this->heap.empty(); }
+};
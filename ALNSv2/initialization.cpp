@@ -1,7 +1,12 @@
 #include "solution.h"
 #include "alns.h"
 #include "tools.h"
+#include "construction.h"
 #include <vector>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <limits>
 
 using namespace std;
 
@@ -16,12 +21,14 @@ All other solution attributes are not set!
 
 @param nr_vehicles
 @param nr_customers
+@param random_generator:	Generator of the calling ALNS object
 */
 vector<vector<int>> route_init_random(
 	const int nr_vehicles, 
 	const int nr_customers,
 	const vector<double> demands,
-	const int max_capacity)
+	const int max_capacity,
+	tools::RandomGenerator &random_generator)
 {
 	// initialize the solution object with multiple routes (nr_vehicles)
 	vector<vector<int>> solution_value(nr_vehicles, vector<int>());
@@ -34,11 +41,11 @@ vector<vector<int>> route_init_random(
 	// However, only allow this if there is enough capacity!
 	while (!node_ids.empty()) {
 		// 1) Get random node id
-		int node_pos = tools::rand_number(node_ids.size() - 1);
+		int node_pos = random_generator.rand_number(node_ids.size() - 1);
 		int node_id = node_ids[node_pos];
 
 		// 2) Assign to random route
-		int route_id_start = tools::rand_number(nr_vehicles - 1);
+		int route_id_start = random_generator.rand_number(nr_vehicles - 1);
 
 		// iterate over the routes to check where we could insert it
 		// the iteration start is created randomlythe next route if there is no place
@@ -90,8 +97,19 @@ vector<vector<int>> route_init_random(
 		2) Evalate the solution and set its values
 		3) Set the initial run solutions of the alns object
 
+	Given initial routes replace the random solution (see warm_start_initialization),
+	otherwise the construction heuristic is used if set (see construct_initial_routes)
 */
 void ALNS::ALNS::initialization() {
+	if (!this->initial_routes.empty()) {
+		this->warm_start_initialization(this->initial_routes);
+		return;
+	}
+	if (this->construction_heuristic != construction::RANDOM) {
+		this->warm_start_initialization(this->construct_initial_routes());
+		return;
+	}
+
 	int max_capacity = this->data_obj.vehicle_cap + this->data_obj.add_pseudo_capacity;
 	vector<vector<int>> solution_rep;
 
@@ -99,7 +117,8 @@ void ALNS::ALNS::initialization() {
 	solution_rep = route_init_random(this->data_obj.nr_vehicles,
 		this->data_obj.nr_customer,
 		this->data_obj.demand,
-		max_capacity);
+		max_capacity,
+		this->random_generator);
 
 	// create solution object
 	Solution initial_solution = Solution(this->data_obj, solution_rep, capa_error_weight, frame_error_weight);
@@ -108,3 +127,112 @@ void ALNS::ALNS::initialization() {
 	this->running_solution = initial_solution;
 	this->current_solution = initial_solution;
 }
+
+/**
+Utility function to insert all customers that are not planned in a solution
+(basic greedy insertion, customer id order)
+*/
+void insert_missing_customers(Solution &solution,
+	tools::RandomGenerator &random_generator,
+	OperatorScratch &scratch,
+	double &capa_error_weight,
+	double &frame_error_weight)
+{
+	vector<int> missing_customers;
+	for (int customer_id = 0; customer_id < solution.data_obj.get().nr_customer; customer_id++) {
+		if (solution.route_positions[customer_id] < 0) {
+			missing_customers.push_back(customer_id);
+		}
+	}
+
+	if (!missing_customers.empty()) {
+		BasicGreedyInsertionOperator insertion(solution,
+			random_generator,
+			scratch,
+			capa_error_weight,
+			frame_error_weight);
+
+		insertion(missing_customers);
+	}
+}
+
+/**
+	Initialization from the given routes (see set_initial_solution) or the constructed routes
+	The process is:
+		1) Evaluate the routes (customers may be missing)
+		2) Insert the missing customers (basic greedy insertion, customer id order)
+		3) Set the initial run solutions of the alns object
+		   (a feasible start is also the best solution -> the plan is never worse than the start)
+*/
+void ALNS::warm_start_initialization(const vector<vector<int>> &routes) {
+	Solution initial_solution = Solution(this->data_obj, routes, capa_error_weight, frame_error_weight);
+
+	insert_missing_customers(initial_solution,
+		this->random_generator,
+		this->operator_scratch,
+		this->capa_error_weight,
+		this->frame_error_weight);
+
+	this->running_solution = initial_solution;
+	this->current_solution = initial_solution;
+
+	if (initial_solution.is_feasible && (initial_solution.driving_time < this->solution.driving_time)) {
+		this->solution = initial_solution;
+	}
+}
+
+/**
+	Best start of the construction heuristic (see set_construction_heuristic)
+	The process is:
+		1) Draw one seed per trial from the generator of this object (reproducible)
+		2) Run the trials on num_threads threads (own generator and scratch per thread)
+		3) Complete each start by the basic greedy insertion (customers that fit into no route)
+		4) Keep the best start: feasible first, then the solution quality
+	A cancel skips the remaining trials (trial 0 always runs -> there is a start)
+*/
+vector<vector<int>> ALNS::construct_initial_routes() {
+	int nr_trials = this->nr_construction_seeds;
+	int nr_threads = max(1, min(this->num_threads, nr_trials));
+
+	vector<uint32_t> seeds(nr_trials);
+	for (int trial = 0; trial < nr_trials; trial++) {
+		seeds[trial] = this->random_generator();
+	}
+
+	vector<vector<vector<int>>> trial_routes(nr_trials);
+	vector<pair<bool, double>> trial_ranks(nr_trials, make_pair(true, numeric_limits<double>::max()));
+
+	auto run_trials = [&](int thread_id) {
+		OperatorScratch scratch;
+		double capa_error_weight = this->capa_error_weight;
+		double frame_error_weight = this->frame_error_weight;
+
+		for (int trial = thread_id; trial < nr_trials; trial += nr_threads) {
+			if ((trial > 0) && this->is_cancelled()) {
+				break;
+			}
+
+			tools::RandomGenerator random_generator(seeds[trial]);
+			vector<vector<int>> routes = construction::get_routes(this->data_obj, this->construction_heuristic, trial, random_generator);
+
+			Solution start_solution(this->data_obj, routes, capa_error_weight, frame_error_weight);
+			insert_missing_customers(start_solution, random_generator, scratch, capa_error_weight, frame_error_weight);
+
+			trial_routes[trial] = start_solution.solution_representation;
+			trial_ranks[trial] = make_pair(!start_solution.is_feasible, start_solution.solution_quality);
+		}
+	};
+
+	vector<thread> threads;
+	for (int thread_id = 1; thread_id < nr_threads; thread_id++) {
+		threads.push_back(thread(run_trials, thread_id));
+	}
+	run_trials(0);
+
+	for (thread &t : threads) {
+		t.join();
+	}
+
+	int best_trial = int(min_element(trial_ranks.begin(), trial_ranks.end()) - trial_ranks.begin());
+	return trial_routes[best_trial];
+}
@@ -0,0 +1,99 @@
+/**
+This file contains the platform dependent memory mapping (Windows and POSIX)
+*/
+#include "mapped_file.h"
+#include <string>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+MappedFile::MappedFile(const string &path) {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw runtime_error("Cannot open the data file: " + path);
+	}
+	this->file_handle = file;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		this->close();
+		throw runtime_error("Empty or unreadable data file: " + path);
+	}
+	this->length = size_t(file_size.QuadPart);
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		this->close();
+		throw runtime_error("Cannot map the data file: " + path);
+	}
+	this->mapping_handle = mapping;
+
+	this->mapped_data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (this->mapped_data == nullptr) {
+		this->close();
+		throw runtime_error("Cannot map the data file: " + path);
+	}
+}
+
+void MappedFile::close() {
+	if (this->mapped_data != nullptr) {
+		UnmapViewOfFile(this->mapped_data);
+		this->mapped_data = nullptr;
+	}
+	if (this->mapping_handle != nullptr) {
+		CloseHandle(this->mapping_handle);
+		this->mapping_handle = nullptr;
+	}
+	if (this->file_handle != nullptr) {
+		CloseHandle(this->file_handle);
+		this->file_handle = nullptr;
+	}
+}
+#else
+MappedFile::MappedFile(const string &path) {
+	this->file_descriptor = open(path.c_str(), O_RDONLY);
+	if (this->file_descriptor < 0) {
+		throw runtime_error("Cannot open the data file: " + path);
+	}
+
+	struct stat file_stat;
+	if (fstat(this->file_descriptor, &file_stat) != 0 || file_stat.st_size == 0) {
+		this->close();
+		throw runtime_error("Empty or unreadable data file: " + path);
+	}
+	this->length = size_t(file_stat.st_size);
+
+	void *mapping = mmap(nullptr, this->length, PROT_READ, MAP_SHARED, this->file_descriptor, 0);
+	if (mapping == MAP_FAILED) {
+		this->close();
+		throw runtime_error("Cannot map the data file: " + path);
+	}
+	this->mapped_data = static_cast<const char*>(mapping);
+}
+
+void MappedFile::close() {
+	if (this->mapped_data != nullptr) {
+		munmap(const_cast<char*>(this->mapped_data), this->length);
+		this->mapped_data = nullptr;
+	}
+	if (this->file_descriptor >= 0) {
+		::close(this->file_descriptor);
+		this->file_descriptor = -1;
+	}
+}
+#endif
+
+MappedFile::~MappedFile() {
+	this->close();
+}
@@ -0,0 +1,35 @@
+/**
+Read only memory mapping of a complete file
+
+All processes that map the same file share its pages (OS page cache).
+The mapping is released with the object.
+*/
+#pragma once
+#include <string>
+#include <cstddef>
+
+class MappedFile {
+private:
+	const char *mapped_data = nullptr;
+	std::size_t length = 0;
+
+#ifdef _WIN32
+	void *file_handle = nullptr;
+	void *mapping_handle = nullptr;
+#else
+	int file_descriptor = -1;
+#endif
+
+	void close();
+
+public:
+	// Map the complete file (throws std::runtime_error if not possible)
+	explicit MappedFile(const std::string &path);
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile& operator=(const MappedFile &) = delete;
+
+	const char* data() const { return this->mapped_data; }
+	std::size_t size() const { return this->length; }
+};
@@ -14,27 +14,218 @@ The following objects are pickleable:
 	1) Data objects (for premature preprocessing)
 	2) Solutions (for future evaluation)
 
+Numpy interface:
+	1) The data constructors accept C contiguous float64 arrays (one memcpy per array, no python objects per element)
+	2) The customer based solution vectors and the time cube are read only numpy views (no copy on access).
+	   A view shares the memory of the C++ object (keeps it alive) and reflects its later changes.
+
 */
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include "alns_data.h"
 #include "alns.h"
 #include "solution.h"
 #include "roulette_wheel.h"
-#include <Windows.h>
+#include "operator_registry.h"
+#include "search_stats.h"
+#include "progress_ring.h"
+#include "batch_solve.h"
+#include "time_cube.h"
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <map>
+#include <functional>
 
 namespace py = pybind11;
 
+// Contiguous float64 buffer (other inputs are handled by the list constructors)
+typedef py::array_t<double, py::array::c_style> DoubleArray;
+
+/**
+Utility functions to copy numpy buffers into the C++ storage
+
+@param array:	Contiguous numpy array
+@param size:	Expected length of each dimension
+@param name:	Argument name for the error message
+*/
+std::vector<double> array_to_vector(const DoubleArray &array, py::ssize_t size, const char *name) {
+	if (array.ndim() != 1 || array.shape(0) != size) {
+		throw std::invalid_argument(std::string(name) + ": expected shape (" + std::to_string(size) + ",)");
+	}
+	return std::vector<double>(array.data(), array.data() + size);
+}
+
+std::vector<std::vector<double>> array_to_matrix(const DoubleArray &array, py::ssize_t size, const char *name) {
+	if (array.ndim() != 2 || array.shape(0) != size || array.shape(1) != size) {
+		throw std::invalid_argument(std::string(name) + ": expected shape (" + std::to_string(size) + ", " + std::to_string(size) + ")");
+	}
+
+	std::vector<std::vector<double>> matrix(size_t(size));
+	for (py::ssize_t i = 0; i < size; i++) {
+		matrix[i].assign(array.data(i, 0), array.data(i, 0) + size);
+	}
+	return matrix;
+}
+
+// [bucket][from][to] is the BUCKET_MAJOR layout -> a single copy
+TimeCube array_to_time_cube(const DoubleArray &array, py::ssize_t nr_nodes, const char *name) {
+	if (array.ndim() != 3 || array.shape(0) < 1 || array.shape(1) != nr_nodes || array.shape(2) != nr_nodes) {
+		throw std::invalid_argument(std::string(name) + ": expected shape (nr_buckets, " + std::to_string(nr_nodes) + ", " + std::to_string(nr_nodes) + ")");
+	}
+
+	TimeCube cube(int(array.shape(0)), int(nr_nodes));
+	std::copy(array.data(), array.data() + cube.size(), cube.data());
+	return cube;
+}
+
+/**
+Read only numpy view of a C++ vector (no copy)
+
+@param values:	Vector inside the C++ object
+@param owner:	Python object of the C++ object (kept alive by the view)
+*/
+template <typename T>
+py::array_t<T> vector_view(const std::vector<T> &values, py::handle owner) {
+	py::array_t<T> view(py::ssize_t(values.size()), values.data(), owner);
+	view.attr("setflags")(py::arg("write") = false);
+	return view;
+}
+
+/**
+Numpy copy of one attribute of all records (progress records, batch results)
+*/
+template <typename R, typename T>
+py::array_t<T> record_column(const std::vector<R> &records, T R::*member) {
+	py::array_t<T> column(py::ssize_t(records.size()));
+	T *values = column.mutable_data();
+	for (std::size_t record_id = 0; record_id < records.size(); record_id++) {
+		values[record_id] = records[record_id].*member;
+	}
+	return column;
+}
+
+/**
+Parameters of a batch job from the keyword arguments of the python ALNS constructor (same names and defaults)
+The construction heuristic is set by "construction_heuristic" and "nr_construction_seeds".
+"log_full_solutions" is accepted and ignored (a batch only returns the BatchResult, no visited solutions).
+*/
+BatchParameters get_batch_parameters(const py::dict &kwargs) {
+	typedef std::function<void(BatchParameters &, py::handle)> Setter;
+	static const std::map<std::string, Setter> setters = {
+		{ "destroy_operators", [](BatchParameters &p, py::handle v) { p.destroy_operators = v.cast<std::vector<std::string>>(); } },
+		{ "repair_operators", [](BatchParameters &p, py::handle v) { p.repair_operators = v.cast<std::vector<std::string>>(); } },
+		{ "max_time", [](BatchParameters &p, py::handle v) { p.max_time = v.cast<int>(); } },
+		{ "max_iterations", [](BatchParameters &p, py::handle v) { p.max_iterations = v.cast<double>(); } },
+		{ "initial_temperature", [](BatchParameters &p, py::handle v) { p.init_temperature = v.cast<double>(); } },
+		{ "cooling_rate", [](BatchParameters &p, py::handle v) { p.cooling_rate = v.cast<double>(); } },
+		{ "wheel_memory_length", [](BatchParameters &p, py::handle v) { p.wheel_memory_length = v.cast<int>(); } },
+		{ "wheel_parameter", [](BatchParameters &p, py::handle v) { p.wheel_parameter = v.cast<double>(); } },
+		{ "functor_reward_best", [](BatchParameters &p, py::handle v) { p.functor_reward_best = v.cast<double>(); } },
+		{ "functor_reward_accept_better", [](BatchParameters &p, py::handle v) { p.functor_reward_accept_better = v.cast<double>(); } },
+		{ "functor_reward_unique", [](BatchParameters &p, py::handle v) { p.functor_reward_unique = v.cast<double>(); } },
+		{ "functor_reward_divers", [](BatchParameters &p, py::handle v) { p.functor_reward_divers = v.cast<double>(); } },
+		{ "functor_penalty", [](BatchParameters &p, py::handle v) { p.functor_penalty = v.cast<double>(); } },
+		{ "functor_min_weight", [](BatchParameters &p, py::handle v) { p.functor_min_weight = v.cast<double>(); } },
+		{ "random_noise", [](BatchParameters &p, py::handle v) { p.random_noise = v.cast<double>(); } },
+		{ "target_inf", [](BatchParameters &p, py::handle v) { p.target_inf = v.cast<double>(); } },
+		{ "shakeup_log", [](BatchParameters &p, py::handle v) { p.shakeup_log = v.cast<double>(); } },
+		{ "mean_removal_log", [](BatchParameters &p, py::handle v) { p.mean_removal_log = v.cast<double>(); } },
+		{ "num_threads", [](BatchParameters &p, py::handle v) { p.num_threads = v.cast<int>(); } },
+		{ "migration_interval", [](BatchParameters &p, py::handle v) { p.migration_interval = v.cast<int>(); } },
+		{ "share_potential_matrix", [](BatchParameters &p, py::handle v) { p.share_potential_matrix = v.cast<bool>(); } },
+		{ "seed", [](BatchParameters &p, py::handle v) { p.seed = v.cast<int>(); } },
+		{ "construction_heuristic", [](BatchParameters &p, py::handle v) { p.construction_heuristic = v.cast<std::string>(); } },
+		{ "nr_construction_seeds", [](BatchParameters &p, py::handle v) { p.nr_construction_seeds = v.cast<int>(); } },
+		{ "log_full_solutions", [](BatchParameters &, py::handle) {} }
+	};
+
+	BatchParameters parameters;
+
+	for (const std::pair<py::handle, py::handle> &item : kwargs) {
+		std::string key = item.first.cast<std::string>();
+		std::map<std::string, Setter>::const_iterator setter = setters.find(key);
+
+		if (setter == setters.end()) {
+			throw std::invalid_argument("Unknown ALNS parameter of the batch: " + key);
+		}
+		setter->second(parameters, item.second);
+	}
+	return parameters;
+}
+
 PYBIND11_MODULE(ALNSv2, m) {
 
 	// 1) ALNS DATA OBJECT
 	py::class_<ALNSData> alns_data(m, "ALNSData");
 
+	// VRPLDTT constructor (numpy arrays, registered first -> preferred for arrays)
+	// noconvert: other inputs must fall through to the list constructors below
+	alns_data.def(py::init([](int nr_veh, int nr_nodes, int nr_customers,
+		const DoubleArray &demand, const DoubleArray &service_times, const DoubleArray &start_window, const DoubleArray &end_window,
+		const DoubleArray &elevation_m, const DoubleArray &distance_m,
+		double load_bucket_size, double nr_load_buckets, int vehicle_weight, int vehicle_capacity, bool compress_time_cube) {
+		return ALNSData(nr_veh,
+			nr_nodes,
+			nr_customers,
+			array_to_vector(demand, nr_customers, "demand"),
+			array_to_vector(service_times, nr_customers, "service_times"),
+			array_to_vector(start_window, nr_customers, "start_window"),
+			array_to_vector(end_window, nr_customers, "end_window"),
+			array_to_matrix(elevation_m, nr_nodes, "elevation_m"),
+			array_to_matrix(distance_m, nr_nodes, "distance_m"),
+			load_bucket_size,
+			nr_load_buckets,
+			vehicle_weight,
+			vehicle_capacity,
+			compress_time_cube);
+	}),
+		py::arg("nr_veh"),
+		py::arg("nr_nodes"),
+		py::arg("nr_customers"),
+		py::arg("demand").noconvert(),
+		py::arg("service_times").noconvert(),
+		py::arg("start_window").noconvert(),
+		py::arg("end_window").noconvert(),
+		py::arg("elevation_m").noconvert(),
+		py::arg("distance_m").noconvert(),
+		py::arg("load_bucket_size") = 0,
+		py::arg("nr_load_buckets") = 0,
+		py::arg("vehicle_weight") = 140,
+		py::arg("vehicle_capacity") = 150,
+		py::arg("compress_time_cube") = false);
+
+	// VRPTW constructor (numpy arrays, time_c of shape (nr_buckets, nr_nodes, nr_nodes))
+	alns_data.def(py::init([](int nr_veh, int nr_nodes, int nr_customers,
+		const DoubleArray &demand, const DoubleArray &service_times, const DoubleArray &start_window, const DoubleArray &end_window,
+		const DoubleArray &time_c, int vehicle_capacity) {
+		return ALNSData(nr_veh,
+			nr_nodes,
+			nr_customers,
+			array_to_vector(demand, nr_customers, "demand"),
+			array_to_vector(service_times, nr_customers, "service_times"),
+			array_to_vector(start_window, nr_customers, "start_window"),
+			array_to_vector(end_window, nr_customers, "end_window"),
+			array_to_time_cube(time_c, nr_nodes, "time_c"),
+			vehicle_capacity);
+	}),
+		py::arg("nr_veh"),
+		py::arg("nr_nodes"),
+		py::arg("nr_customers"),
+		py::arg("demand").noconvert(),
+		py::arg("service_times").noconvert(),
+		py::arg("start_window").noconvert(),
+		py::arg("end_window").noconvert(),
+		py::arg("time_c").noconvert(),
+		py::arg("vehicle_capacity") = 150);
+
 	// VRPLDTT constructor
 	alns_data.def(py::init<int, int, int,
 		std::vector<double>, std::vector<double>, std::vector<double>, std::vector<double>,
 		std::vector<std::vector<double>>, std::vector<std::vector<double>>,
-		double, double, int, int>(),
+		double, double, int, int, bool>(),
 		py::arg("nr_veh"),
 		py::arg("nr_nodes"),
 		py::arg("nr_customers"),
@@ -47,7 +238,8 @@ PYBIND11_MODULE(ALNSv2, m) {
 		py::arg("load_bucket_size") = 0,
 		py::arg("nr_load_buckets") = 0,
 		py::arg("vehicle_weight") = 140,
-		py::arg("vehicle_capacity") = 150);
+		py::arg("vehicle_capacity") = 150,
+		py::arg("compress_time_cube") = false);
 
 	// VRPTW constructor
 	alns_data.def(py::init<int, int, int,
@@ -80,15 +272,17 @@ PYBIND11_MODULE(ALNSv2, m) {
 			obj.end_window,
 			obj.slope_matrix,
 			obj.distance_matrix,
-			obj.time_cube,
+			obj.time_cube.to_nested(),
 			obj.load_bucket_size,
 			obj.vehicle_weight,
-			obj.vehicle_cap);
+			obj.vehicle_cap,
+			obj.time_cube.is_compressed());
 	},
 		[](py::tuple t) {
 		// __setstate__ (of python object)
 		// Must be declared so that it can deserialize
-		if (t.size() != 13) {
+		// (13: states without the compression flag)
+		if (t.size() != 13 && t.size() != 14) {
 			throw std::runtime_error("Invalid state!");
 		}
 
@@ -106,6 +300,10 @@ PYBIND11_MODULE(ALNSv2, m) {
 			t[10].cast<double>(), // load_b
 			t[11].cast<int>(), // veh_weight
 			t[12].cast<int>()); // veh_cap
+
+		if (t.size() == 14 && t[13].cast<bool>()) {
+			obj.time_cube.set_layout(TimeCube::COMPRESSED);
+		}
 		return obj;
 	}
 	));
@@ -117,12 +315,68 @@ PYBIND11_MODULE(ALNSv2, m) {
 	alns_data.def_readonly("nr_vehicles", &ALNSData::nr_vehicles);
 	alns_data.def_readonly("nr_nodes", &ALNSData::nr_nodes);
 	alns_data.def_readonly("nr_customer", &ALNSData::nr_customer);
-	alns_data.def_readonly("customer_demands", &ALNSData::demand);
-	alns_data.def_readonly("service_times", &ALNSData::service_times);
-	alns_data.def_readonly("start_window", &ALNSData::start_window);
-	alns_data.def_readonly("end_window", &ALNSData::end_window);
+	alns_data.def_property_readonly("customer_demands", [](py::object obj) {return vector_view(obj.cast<const ALNSData &>().demand, obj); });
+	alns_data.def_property_readonly("service_times", [](py::object obj) {return vector_view(obj.cast<const ALNSData &>().service_times, obj); });
+	alns_data.def_property_readonly("start_window", [](py::object obj) {return vector_view(obj.cast<const ALNSData &>().start_window, obj); });
+	alns_data.def_property_readonly("end_window", [](py::object obj) {return vector_view(obj.cast<const ALNSData &>().end_window, obj); });
 	alns_data.def_readonly("slope_matrix", &ALNSData::slope_matrix);
-	alns_data.def_readonly("time_cube", &ALNSData::time_cube);
+
+	// The time cube is stored flat -> strided view [bucket][from][to] (valid for both dense layouts)
+	// A compressed cube has no strided form -> dense copy
+	alns_data.def_property_readonly("time_cube", [](py::object obj) {
+		const TimeCube &cube = obj.cast<const ALNSData &>().time_cube;
+		py::ssize_t nr_buckets = cube.get_nr_buckets();
+		py::ssize_t nr_nodes = cube.get_nr_nodes();
+
+		if (cube.is_compressed()) {
+			py::array_t<double> copy({ nr_buckets, nr_nodes, nr_nodes });
+			auto values = copy.mutable_unchecked<3>();
+			for (py::ssize_t bucket = 0; bucket < nr_buckets; bucket++) {
+				for (py::ssize_t i = 0; i < nr_nodes; i++) {
+					for (py::ssize_t j = 0; j < nr_nodes; j++) {
+						values(bucket, i, j) = cube(int(bucket), int(i), int(j));
+					}
+				}
+			}
+			return copy;
+		}
+
+		py::array_t<double> view({ nr_buckets, nr_nodes, nr_nodes },
+			{ py::ssize_t(cube.get_stride_bucket() * sizeof(double)),
+			py::ssize_t(cube.get_stride_from() * sizeof(double)),
+			py::ssize_t(cube.get_stride_to() * sizeof(double)) },
+			cube.data(),
+			obj);
+		view.attr("setflags")(py::arg("write") = false);
+		return view;
+	});
+
+	alns_data.def("get_time_cube_nested", [](const ALNSData &obj) {
+		return obj.time_cube.to_nested();
+	});
+
+	alns_data.def("set_time_cube_layout", [](ALNSData &obj, bool arc_major, bool compressed) {
+		if (compressed) {
+			obj.time_cube.set_layout(TimeCube::COMPRESSED);
+		}
+		else {
+			obj.time_cube.set_layout(arc_major ? TimeCube::ARC_MAJOR : TimeCube::BUCKET_MAJOR);
+		}
+	},
+		py::arg("arc_major") = false,
+		py::arg("compressed") = false);
+
+	alns_data.def_property_readonly("time_cube_compressed", [](const ALNSData &obj) { return obj.time_cube.is_compressed(); });
+	alns_data.def_property_readonly("time_cube_memory_size", [](const ALNSData &obj) { return obj.time_cube.memory_size(); });
+
+	// Binary data file (memory mapped time cube, no preprocessing on load)
+	alns_data.def("save", &ALNSData::save, py::arg("path"));
+	alns_data.def_static("load_mmap", &ALNSData::load_mmap, py::arg("path"));
+
+	// Granular neighbourhood (not pickled, set again after unpickling)
+	alns_data.def("set_candidate_lists", &ALNSData::set_candidate_lists, py::arg("nr_candidates"));
+	alns_data.def_readonly("nr_candidates", &ALNSData::nr_candidates);
+	alns_data.def_readonly("candidate_lists", &ALNSData::candidate_lists);
 
 	// 2) ALNS SOLVER OBJECT
 	py::class_<ALNS> alns_class(m, "ALNS");
@@ -145,7 +399,12 @@ PYBIND11_MODULE(ALNSv2, m) {
 		double,
 		double,
 		double,
-		double>(),
+		double,
+		int,
+		int,
+		bool,
+		int,
+		bool>(),
 		py::arg("data_object"),
 		py::arg("destroy_operators"),
 		py::arg("repair_operators"),
@@ -164,13 +423,23 @@ PYBIND11_MODULE(ALNSv2, m) {
 		py::arg("random_noise") = 0,
 		py::arg("target_inf") = 0.2,
 		py::arg("shakeup_log") = 20,
-		py::arg("mean_removal_log") = 2);
+		py::arg("mean_removal_log") = 2,
+		py::arg("num_threads") = 1,
+		py::arg("migration_interval") = 1000,
+		py::arg("share_potential_matrix") = false,
+		py::arg("seed") = -1,
+		py::arg("log_full_solutions") = false);
 
 	// Only some parts of the internal workings relevant
 	alns_class.def_readonly("solution", &ALNS::solution);
-	alns_class.def_readonly("visited_solutions", &ALNS::visited_solutions);
+	alns_class.def_readonly("visited_solutions", &ALNS::visited_solutions); // empty if not log_full_solutions
+	alns_class.def_property_readonly("nr_visited_solutions", [](const ALNS &alns) {return alns.visited_set.size(); });
+	alns_class.def("get_visited_time_stamps", [](const ALNS &alns, size_t max_count) {
+		return alns.visited_set.get_time_stamps(max_count);
+	}, py::arg("max_count") = 100000);
 	alns_class.def_readonly("DestroyWheel", &ALNS::destroy_wheel);
 	alns_class.def_readonly("InsertionWheel", &ALNS::insertion_wheel);
+	alns_class.def_readonly("stats", &ALNS::stats);
 	alns_class.def_readonly("capa_error_weight", &ALNS::capa_error_weight);
 	alns_class.def_readonly("frame_error_weight", &ALNS::frame_error_weight);
 	alns_class.def_readonly("iterations", &ALNS::iterations);
@@ -178,7 +447,59 @@ PYBIND11_MODULE(ALNSv2, m) {
 	alns_class.def_readonly("value", &ALNS::value);
 
 	// Define the function interface (only solve relevant)
-	alns_class.def("solve", &ALNS::solve);
+	// The search does not touch python objects -> release the GIL (parallel python threads)
+	alns_class.def("solve", static_cast<Solution (ALNS::*)()>(&ALNS::solve), py::call_guard<py::gil_scoped_release>());
+
+	// Warm start / re-optimisation: customers missing in the routes are inserted greedily
+	alns_class.def("solve", static_cast<Solution (ALNS::*)(const Solution &)>(&ALNS::solve),
+		py::arg("initial_solution"), py::call_guard<py::gil_scoped_release>());
+	alns_class.def("solve", static_cast<Solution (ALNS::*)(const std::vector<std::vector<int>> &)>(&ALNS::solve),
+		py::arg("initial_routes"), py::call_guard<py::gil_scoped_release>());
+	alns_class.def("set_initial_solution", &ALNS::set_initial_solution, py::arg("initial_routes"));
+
+	// Construction heuristic of the initial solution ("random", "savings", "solomon_i1", "sweep"), best of nr_seeds trials
+	alns_class.def("set_construction_heuristic", &ALNS::set_construction_heuristic, py::arg("heuristic"), py::arg("nr_seeds") = 1);
+	alns_class.def_property_readonly("construction_heuristic", &ALNS::get_construction_heuristic);
+
+	// Progress log (lock free ring): drain it from another python thread while solve runs
+	// (dict of numpy arrays, one entry per record, see progress_ring.h)
+	alns_class.def("set_progress_log", &ALNS::set_progress_log, py::arg("capacity"), py::arg("interval") = 0);
+	alns_class.def("drain_progress", [](ALNS &alns, std::int64_t max_records) {
+		std::vector<ProgressRecord> records = alns.drain_progress(max_records);
+
+		py::dict columns;
+		columns["time_stamp"] = record_column(records, &ProgressRecord::time_stamp);
+		columns["iteration"] = record_column(records, &ProgressRecord::iteration);
+		columns["best_driving_time"] = record_column(records, &ProgressRecord::best_driving_time);
+		columns["current_quality"] = record_column(records, &ProgressRecord::current_quality);
+		columns["temperature"] = record_column(records, &ProgressRecord::temperature);
+		columns["destroy_id"] = record_column(records, &ProgressRecord::destroy_id);
+		columns["repair_id"] = record_column(records, &ProgressRecord::repair_id);
+		columns["island_id"] = record_column(records, &ProgressRecord::island_id);
+		columns["is_improvement"] = record_column(records, &ProgressRecord::is_improvement);
+		return columns;
+	}, py::arg("max_records") = -1);
+	alns_class.def_property_readonly("nr_dropped_progress", &ALNS::get_nr_dropped_progress);
+
+	// Learned state (wheel weights, node pair matrices) to seed the search of another ALNS object
+	alns_class.def("get_search_memory", &ALNS::get_search_memory);
+	alns_class.def("set_search_memory", &ALNS::set_search_memory, py::arg("memory"), py::arg("node_map") = std::vector<int>());
+
+	// Time sliced search (resumes the previous call) and cooperative cancel (callable from any thread)
+	alns_class.def("solve_for", &ALNS::solve_for, py::arg("time_ms"), py::call_guard<py::gil_scoped_release>());
+	alns_class.def("reset_search", &ALNS::reset_search);
+	alns_class.def("cancel", &ALNS::cancel);
+	alns_class.def_property_readonly("search_finished", &ALNS::is_search_finished);
+
+	// Operator names in the order of the wheels and stats (registry of the operators)
+	alns_class.def_property_readonly("destroy_operators", [](const ALNS &alns) {return alns.operator_registry.get_destroy_names(); });
+	alns_class.def_property_readonly("repair_operators", [](const ALNS &alns) {return alns.operator_registry.get_repair_names(); });
+
+	// Available operator types (with their parameter names) and predefined variants
+	// e.g. ALNS(data, ["shaw_destroy(distance=1, noise=0.2)"], ["k_regret(k=4)"])
+	m.def("get_destroy_operator_types", &OperatorRegistry::get_destroy_types);
+	m.def("get_repair_operator_types", &OperatorRegistry::get_repair_types);
+	m.def("get_operator_aliases", &OperatorRegistry::get_aliases);
 
 	// -> Rest is irrelevant as its custom input by the user
 
@@ -246,10 +567,10 @@ PYBIND11_MODULE(ALNSv2, m) {
 
 	solution_obj.def_readonly("solution", &Solution::solution_representation);
 
-	// Provide read access to customer based info
-	solution_obj.def_readonly("loads", &Solution::loads);
-	solution_obj.def_readonly("arrival_times", &Solution::arrival_times);
-	solution_obj.def_readonly("departure_times", &Solution::departure_times);
+	// Provide read access to customer based info (numpy views)
+	solution_obj.def_property_readonly("loads", [](py::object obj) {return vector_view(obj.cast<const Solution &>().loads, obj); });
+	solution_obj.def_property_readonly("arrival_times", [](py::object obj) {return vector_view(obj.cast<const Solution &>().arrival_times, obj); });
+	solution_obj.def_property_readonly("departure_times", [](py::object obj) {return vector_view(obj.cast<const Solution &>().departure_times, obj); });
 
 	// Provide read access to KPIs of solution (also infeasible solutions visited)
 	solution_obj.def_readonly("quality", &Solution::solution_quality);
@@ -259,8 +580,8 @@ PYBIND11_MODULE(ALNSv2, m) {
 	solution_obj.def_readonly("is_feasible", &Solution::is_feasible);
 
 	// Provide access to the route KPIs
-	solution_obj.def_readonly("start_times", &Solution::start_times);
-	solution_obj.def_readonly("route_driving_times", &Solution::route_driving_times);
+	solution_obj.def_property_readonly("start_times", [](py::object obj) {return vector_view(obj.cast<const Solution &>().start_times, obj); });
+	solution_obj.def_property_readonly("route_driving_times", [](py::object obj) {return vector_view(obj.cast<const Solution &>().route_driving_times, obj); });
 
 	// 4) ROULETTE WHEEL
 	// destroy roulette wheel
@@ -268,10 +589,96 @@ PYBIND11_MODULE(ALNSv2, m) {
 
 	wheel_obj.def_readonly("weights", &RouletteWheel::weights);
 	wheel_obj.def_readonly("nr_uses", &RouletteWheel::nr_uses);
+
+	// operator statistics of the whole search (operator order of the ALNS arguments)
+	wheel_obj.def_readonly("nr_selections", &RouletteWheel::nr_selections);
+	wheel_obj.def_readonly("selection_times", &RouletteWheel::selection_times);
 	
 	py::class_<DestroyRouletteWheel, RouletteWheel>(m, "DestroyRouletteWheel");
 	py::class_<InsertionRouletteWheel, RouletteWheel>(m, "InsertionRouletteWheel");
 
+	// SEARCH MEMORY (warm start, picklable -> can be stored between the runs of a service)
+	py::class_<SearchMemory> memory_obj(m, "SearchMemory");
+
+	memory_obj.def(py::init<>());
+	memory_obj.def_readwrite("destroy_operators", &SearchMemory::destroy_operators);
+	memory_obj.def_readwrite("destroy_weights", &SearchMemory::destroy_weights);
+	memory_obj.def_readwrite("repair_operators", &SearchMemory::repair_operators);
+	memory_obj.def_readwrite("repair_weights", &SearchMemory::repair_weights);
+	memory_obj.def_readwrite("nr_nodes", &SearchMemory::nr_nodes);
+	memory_obj.def_readwrite("node_pair_potential_matrix", &SearchMemory::node_pair_potential_matrix);
+	memory_obj.def_readwrite("node_pair_usage_matrix", &SearchMemory::node_pair_usage_matrix);
+
+	memory_obj.def(py::pickle(
+		[](const SearchMemory &obj) {
+		return py::make_tuple(obj.destroy_operators,
+			obj.destroy_weights,
+			obj.repair_operators,
+			obj.repair_weights,
+			obj.nr_nodes,
+			obj.node_pair_potential_matrix,
+			obj.node_pair_usage_matrix);
+	},
+		[](py::tuple t) {
+		if (t.size() != 7) {
+			throw std::runtime_error("Invalid state!");
+		}
+
+		SearchMemory obj;
+		obj.destroy_operators = t[0].cast<std::vector<std::string>>();
+		obj.destroy_weights = t[1].cast<std::vector<double>>();
+		obj.repair_operators = t[2].cast<std::vector<std::string>>();
+		obj.repair_weights = t[3].cast<std::vector<double>>();
+		obj.nr_nodes = t[4].cast<int>();
+		obj.node_pair_potential_matrix = t[5].cast<std::vector<float>>();
+		obj.node_pair_usage_matrix = t[6].cast<std::vector<std::uint32_t>>();
+		return obj;
+	}
+	));
+
+	// 5) SEARCH STATS (steady clock, nanoseconds)
+	py::class_<SearchStats> stats_obj(m, "SearchStats");
+
+	stats_obj.def_readonly("destroy_calls", &SearchStats::destroy_calls);
+	stats_obj.def_readonly("destroy_times_ns", &SearchStats::destroy_times_ns);
+	stats_obj.def_readonly("insertion_calls", &SearchStats::insertion_calls);
+	stats_obj.def_readonly("insertion_times_ns", &SearchStats::insertion_times_ns);
+	stats_obj.def_readonly("nr_iterations", &SearchStats::nr_iterations);
+	stats_obj.def_readonly("iteration_time_ns", &SearchStats::iteration_time_ns);
+	stats_obj.def_readonly("historic_update_time_ns", &SearchStats::historic_update_time_ns);
+	stats_obj.def_readonly("visited_lookup_time_ns", &SearchStats::visited_lookup_time_ns);
+	stats_obj.def_readonly("solution_copy_time_ns", &SearchStats::solution_copy_time_ns);
+	stats_obj.def_readonly("migration_time_ns", &SearchStats::migration_time_ns);
+	stats_obj.def_readonly("nr_evaluated_changes", &SearchStats::nr_evaluated_changes);
+	stats_obj.def_readonly("nr_rejected_changes", &SearchStats::nr_rejected_changes);
+
+	// 6) BATCH SOLVE (native thread pool, see batch_solve.h)
+	// solve_batch([(data_object, kwargs), ...], num_threads=0) with the keyword arguments of the ALNS constructor
+	// (data objects are shared by reference, the GIL is released, dict of numpy arrays in the order of the jobs)
+	m.def("solve_batch", [](py::sequence batch, int num_threads) {
+		std::vector<BatchJob> jobs;
+		for (py::handle item : batch) {
+			py::sequence job = item.cast<py::sequence>();
+			if (job.size() != 2) {
+				throw std::invalid_argument("Each job of the batch must be a (data_object, kwargs) pair");
+			}
+			jobs.push_back({ &job[0].cast<ALNSData &>(), get_batch_parameters(job[1].cast<py::dict>()) });
+		}
+
+		std::vector<BatchResult> results;
+		{
+			py::gil_scoped_release release;
+			results = solve_batch(jobs, num_threads);
+		}
+
+		py::dict columns;
+		columns["value"] = record_column(results, &BatchResult::value);
+		columns["iterations"] = record_column(results, &BatchResult::iterations);
+		columns["solution_time_ms"] = record_column(results, &BatchResult::solution_time_ms);
+		columns["feasible"] = record_column(results, &BatchResult::is_feasible);
+		return columns;
+	}, py::arg("jobs"), py::arg("num_threads") = 0);
+
 
 
 #ifdef VERSION_INFO
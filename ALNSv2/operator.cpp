@@ -1,11 +1,13 @@
 #include "evaluate.h"
 #include "operator.h"
 #include "tools.h"
+#include "indexed_heap.h"
 #include <tuple>
 #include <functional>
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <numeric>
 
 using namespace std;
 
@@ -28,6 +30,10 @@ Efficiency annotation:
 
 	- Instead of copying the solution object / route every iteration we reset the temporary
 		adjustments back to normal.
+	- Capacity infeasible routes are rejected in O(1) (head load) without touching the route.
+
+@return:	Solution quality after the insertion
+			(max double if the max capa error is exceeded -> not insertable in the route at all)
 */
 double evaluate_insertion_position(
 	Solution &solution_obj,
@@ -37,28 +43,22 @@ double evaluate_insertion_position(
 	const int customer_id,
 	const int ins_pos)
 {
+	const ALNSData &data = solution_obj.data_obj.get();
 	vector<int> &route = solution_obj.solution_representation[route_id];
 
-	try {
-		// perform insertion
-		route.insert(route.begin() + ins_pos, customer_id);
-		solution_obj.route_chromosome[customer_id] = route_id;
-
-		// reevaluate solution
-		solution_obj.evaluate_change(route_id, ins_pos, capa_error_weight, frame_error_weight);
-
+	if (solution_obj.exceeds_max_capa_error(route_id, data.demand[customer_id])) {
+		return std::numeric_limits<double>::max();
 	}
-	catch (InfeasibilityException) {
-		tools::remove_at(route, ins_pos);
-		solution_obj.evaluate_change(route_id, ins_pos - 1, capa_error_weight, frame_error_weight);
 
-		// Use exception to realize when an insertion is completely not possible
-		// -> efficiency
-		throw InfeasibilityException();
-	}
+	// perform insertion
+	route.insert(route.begin() + ins_pos, customer_id);
+	solution_obj.route_chromosome[customer_id] = route_id;
 
-	// Check if performance improved
-	double tmp_cost = solution_obj.solution_quality;
+	// reevaluate solution and check if performance improved
+	double tmp_cost = std::numeric_limits<double>::max();
+	if (solution_obj.try_evaluate_change(route_id, ins_pos, capa_error_weight, frame_error_weight)) {
+		tmp_cost = solution_obj.solution_quality;
+	}
 
 	// 3) Reset insertions (Annotation: ins_pos is always inclusive in the removal
 	tools::remove_at(route, ins_pos);
@@ -77,42 +77,44 @@ Efficiency annotation:
 
 	- Instead of copying the solution object / route every iteration we reset the temporary
 		adjustments back to normal.
+	- Capacity infeasible routes are rejected in O(1) (head load) without touching the route.
+
+@return:	Solution quality after the insertion
+			(max double if the max capa error is exceeded -> not insertable in the route at all)
 */
 double evaluate_insertion_chain(
 	Solution &solution_obj,
 	const double capa_error_weight,
 	const double frame_error_weight,
 	const int route_id,
-	const vector<int> customer_ids,
+	const vector<int> &customer_ids,
 	const int ins_pos) 
 {
+	const ALNSData &data = solution_obj.data_obj.get();
 	vector<int> &route = solution_obj.solution_representation[route_id];
 
-	int add_pos = 0;
-	try {
-		// perform insertion
-		for (int customer_id : customer_ids) {
-			route.insert(route.begin() + ins_pos + add_pos, customer_id);
-			solution_obj.route_chromosome[customer_id] = route_id;
-			add_pos++;
-		}
-
-		// reevaluate solution
-		solution_obj.evaluate_change(route_id, ins_pos + add_pos - 1, capa_error_weight, frame_error_weight);
+	double chain_demand = 0;
+	for (int customer_id : customer_ids) {
+		chain_demand += data.demand[customer_id];
+	}
 
+	if (solution_obj.exceeds_max_capa_error(route_id, chain_demand)) {
+		return std::numeric_limits<double>::max();
 	}
-	catch (InfeasibilityException) {
-		for (int rem_pos = 0; rem_pos < add_pos; rem_pos++) {
-			tools::remove_at(route, ins_pos);
-		}
-		solution_obj.evaluate_change(route_id, ins_pos - 1, capa_error_weight, frame_error_weight);
-		throw InfeasibilityException();
-		// Use exception to realize when an insertion is completely not possible
-		// -> efficiency
+
+	// perform insertion
+	int add_pos = 0;
+	for (int customer_id : customer_ids) {
+		route.insert(route.begin() + ins_pos + add_pos, customer_id);
+		solution_obj.route_chromosome[customer_id] = route_id;
+		add_pos++;
 	}
 
-	// Check if performance improved
-	double tmp_cost = solution_obj.solution_quality;
+	// reevaluate solution and check if performance improved
+	double tmp_cost = std::numeric_limits<double>::max();
+	if (solution_obj.try_evaluate_change(route_id, ins_pos + add_pos - 1, capa_error_weight, frame_error_weight)) {
+		tmp_cost = solution_obj.solution_quality;
+	}
 
 	// 3) Reset insertions (Annotation: ins_pos is always inclusive in the removal
 	for (int rem_pos = 0; rem_pos < add_pos; rem_pos++) {
@@ -123,15 +125,38 @@ double evaluate_insertion_chain(
 }
 
 /**
-	Get best insertion position within a route
+	Get the k best insertion positions (cost, route_id, route_pos) sorted by cost
+
+	Efficiency annotation:
+		- The route is not changed. The shifted prefix is computed once per route
+			and all positions are then evaluated in one pass with the route segment
+			summaries (see Solution::get_insertion_costs).
+		- Granular neighbourhood (if candidate lists are set): Only positions adjacent
+			to a candidate of the customer and empty routes are evaluated.
+			If no position is found in any route all positions are evaluated.
+			A single route without candidates returns no position.
+		- Pruning (prune): Once k positions are found, positions whose lower bound is not
+			below the k-th best cost are skipped before their delay propagation
+			(see Solution::get_insertion_costs). The result is identical.
+
+	Annotation: Positions of equal cost keep the route and position order.
 */
-tuple<double, int, int> get_best_insertion(
+void get_best_insertions(
 	int customer_id,
 	Solution &solution_obj,
 	double const &capa_error_weight,
 	double const &frame_error_weight,
-	int route_id = -1)
+	int k,
+	vector<tuple<double, int, int>> &best_insertions,
+	InsertionPrefix &prefix,
+	int route_id = -1,
+	bool granular = true,
+	bool prune = true)
 {
+	const ALNSData &data = solution_obj.data_obj.get();
+	granular = granular && !data.candidate_lists.empty();
+	best_insertions.clear();
+
 	int start_id;
 	int stop_id;
 
@@ -144,37 +169,78 @@ tuple<double, int, int> get_best_insertion(
 		stop_id = solution_obj.solution_representation.size();
 	}
 
-	// get the best insertion position!
-	double min_cost = std::numeric_limits<double>::max();
-	tuple<double, int, int> best_insertion(min_cost, 0, 0);
-
 	for (int rid = start_id; rid < stop_id; rid++) {
 		vector<int> &route = solution_obj.solution_representation[rid];
 
+		// Skip routes without any candidate (empty routes are always evaluated)
+		bool restricted = granular && !route.empty();
+		const vector<bool> *is_candidate = restricted ? &data.candidate_matrix[customer_id] : nullptr;
+
+		if (restricted && std::none_of(route.begin(), route.end(), [is_candidate](int id) {return (*is_candidate)[id]; })) {
+			continue;
+		}
+
+		// O(1) capacity check first: all insertion positions in that route exceed max infeasibility!
+		if (!solution_obj.set_insertion_prefix(customer_id, rid, prefix)) {
+			continue;
+		}
+
 		// First and last position insertion is done correctly implicitly! (depot distance is considered)
+		// (k-th best so far as bound, k = 1: the bound follows the best position of this route as well)
+		double max_cost = (prune && (int(best_insertions.size()) == k)) ? std::get<0>(best_insertions.back()) : std::numeric_limits<double>::max();
+		solution_obj.get_insertion_costs(prefix, capa_error_weight, frame_error_weight, is_candidate, max_cost, prune && (k == 1));
+
 		for (unsigned int pos = 0; pos <= route.size(); pos++) {
-			try {
-				double tmp_cost = evaluate_insertion_position(
-					solution_obj,
-					capa_error_weight,
-					frame_error_weight,
-					rid,
-					customer_id,
-					pos) - solution_obj.solution_quality; // comparison remains iteration independent
+			double tmp_cost = prefix.costs[pos];
 
-				// perform comparision
-				if (min_cost > tmp_cost) {
-					min_cost = tmp_cost;
-					best_insertion = tuple<double, int, int>(tmp_cost, rid, pos);
-				}
+			// skipped position or not within the k best
+			if ((tmp_cost == std::numeric_limits<double>::max())
+				|| ((int(best_insertions.size()) == k) && !(std::get<0>(best_insertions.back()) > tmp_cost))) {
+				continue;
+			}
+
+			if (int(best_insertions.size()) == k) {
+				best_insertions.pop_back();
 			}
-			catch (InfeasibilityException) {
-				// We know that all other insertion positions in that route also exceed max infeasibility!
-				break;
+
+			// insert behind all positions of equal cost
+			vector<tuple<double, int, int>>::iterator it = best_insertions.end();
+			while ((it != best_insertions.begin()) && (std::get<0>(*(it - 1)) > tmp_cost)) {
+				it--;
 			}
+			best_insertions.insert(it, tuple<double, int, int>(tmp_cost, rid, pos));
 		}
 	}
-	return best_insertion;
+
+	// No candidate position at all -> fall back to the full neighbourhood
+	if (granular && (route_id < 0) && best_insertions.empty()) {
+		get_best_insertions(customer_id, solution_obj, capa_error_weight, frame_error_weight, k, best_insertions, prefix, route_id, false, prune);
+	}
+}
+
+/**
+	Get best insertion position (within a route if route_id >= 0)
+	(max cost if there is no position, see get_best_insertions)
+
+	@param scratch	buffers of the search (prefix, best_insertions)
+*/
+tuple<double, int, int> get_best_insertion(
+	int customer_id,
+	Solution &solution_obj,
+	double const &capa_error_weight,
+	double const &frame_error_weight,
+	OperatorScratch &scratch,
+	int route_id = -1,
+	bool granular = true,
+	bool prune = true)
+{
+	vector<tuple<double, int, int>> &best_insertions = scratch.best_insertions;
+	get_best_insertions(customer_id, solution_obj, capa_error_weight, frame_error_weight, 1, best_insertions, scratch.prefix, route_id, granular, prune);
+
+	if (best_insertions.empty()) {
+		return tuple<double, int, int>(std::numeric_limits<double>::max(), 0, 0);
+	}
+	return best_insertions[0];
 }
 
 /**
@@ -234,33 +300,22 @@ double evaluate_removal_position(
 	Usage:
 		Mainly used for diversification
 */
-vector<int> RandomDestroyOperator::operator()(){
+void RandomDestroyOperator::operator()(vector<int> &removed_customers) {
 	// base init for each destroy operator
-	vector<vector<int>> tmp_destroyed_route; // for efficiency reasons allocate
-	vector<int> removed_customers;
+	removed_customers.clear();
 
 	for (vector<int> & route : this->solution_obj.solution_representation) {
-		vector<int> new_route;
-
 		for (int customer_id : route) {
-			int rnd_int = tools::rand_number(this->solution_obj.data_obj.get().nr_customer, 0);
+			int rnd_int = this->random_generator.rand_number(this->solution_obj.data_obj.get().nr_customer, 0);
 
-			if (rnd_int > this->mean_removal) {
-				new_route.push_back(customer_id);
-			}
-			else {
+			if (rnd_int <= this->mean_removal) {
 				removed_customers.push_back(customer_id);
 			}
 		}
-		tmp_destroyed_route.push_back(new_route); 
 	}
 
-	// Set the respective values
-	this->solution_obj.solution_representation = tmp_destroyed_route;
-
-	// reevaluate solution (TODO optimize)
-	this->solution_obj.evaluate_solution(this->capa_error_weight, this->frame_error_weight);
-	return removed_customers;
+	// reevaluate only the changed routes
+	this->solution_obj.remove_customers(removed_customers, this->capa_error_weight, this->frame_error_weight);
 }
 
 /**
@@ -269,18 +324,17 @@ vector<int> RandomDestroyOperator::operator()(){
 	Usage:
 		Reducation of routes (if necessary)
 */
-vector<int> RandomRouteDestroyOperator::operator()() {
+void RandomRouteDestroyOperator::operator()(vector<int> &removed_customers) {
 	// Get the random route id
-	int route_id = tools::rand_number(this->solution_obj.data_obj.get().nr_vehicles-1, 0);
+	int route_id = this->random_generator.rand_number(this->solution_obj.data_obj.get().nr_vehicles-1, 0);
 
 	// save new route
-	vector<int> removed_customers = this->solution_obj.solution_representation[route_id]; // call by value per default
-	this->solution_obj.solution_representation[route_id].clear(); // destroy route
+	const vector<int> &route = this->solution_obj.solution_representation[route_id];
+	removed_customers.assign(route.begin(), route.end());
 
-	// reevaluate solution (TODO: optimize)
-	this->solution_obj.evaluate_solution(this->capa_error_weight, this->frame_error_weight);
+	// destroy route (only this route is reevaluated)
+	this->solution_obj.remove_customers(removed_customers, this->capa_error_weight, this->frame_error_weight);
 
-	return removed_customers;
 }
 
 
@@ -294,39 +348,30 @@ Annotation:
 	We want to prohibit repetitiveness and stale selection.
 	This is why we use the general randomness factor
 */
-vector<int> BiggestDemandDestroyOperator::operator()() {
+void BiggestDemandDestroyOperator::operator()(vector<int> &removed_customers) {
 	// Perform randomization!
 	ALNSData &data = this->solution_obj.data_obj.get();
 
 	vector<double> skewed_demand_ranks(data.nr_customer);
 
-	int rnd_int = tools::rand_number_normal(this->mean_removal, this->mean_removal / 2);
+	int rnd_int = this->random_generator.rand_number_normal(this->mean_removal, this->mean_removal / 2);
 	rnd_int = max(0, min(data.nr_customer - 1, rnd_int));
 
 	for (int i = 0; i < data.nr_customer; i++) {
 		// double bias = VNI;
 		// skewed_demand_ranks[i] = this->demand_ranks[i]+(rnd_int * bias);
 
-		double bias = std::pow(UNI, this->rnd_factor);
+		double bias = std::pow(this->random_generator.uniform(), this->rnd_factor);
 		skewed_demand_ranks[i] = this->demand_ranks[i] * bias;
 	}
 
 	vector<int> sorted_indices = tools::sort_indices(skewed_demand_ranks);
 
 	// return removed customers (increasing order -> take back)
-	vector<int> removed_customers(sorted_indices.end()-rnd_int, sorted_indices.end());
-
-	// destroy routes! (with use of chromosomes)
-	for (int customer_id : removed_customers) {
-		int route_id = solution_obj.route_chromosome[customer_id];
-		vector<int> &route = solution_obj.solution_representation[route_id];
-		int customer_pos = route_evaluate::get_customer_pos(route, customer_id);
-		tools::remove_at(this->solution_obj.solution_representation[route_id], customer_pos);
-	}
-
+	removed_customers.assign(sorted_indices.end()-rnd_int, sorted_indices.end());
 
-	this->solution_obj.evaluate_solution(this->capa_error_weight, this->frame_error_weight);
-	return removed_customers;
+	// destroy routes! (batched, only the changed routes are reevaluated)
+	this->solution_obj.remove_customers(removed_customers, this->capa_error_weight, this->frame_error_weight);
 }
 
 /**
@@ -338,7 +383,7 @@ Annotation:
 	This is why we use the general randomness factor
 
 */
-vector<int> WorstTravelTimeDestroyOperator::operator()() {
+void WorstTravelTimeDestroyOperator::operator()(vector<int> &removed_customers) {
 	// 1) Get travel times (is not worth to save as seperate attribute)
 	ALNSData &data = this->solution_obj.data_obj.get();
 	vector<double> travel_times(data.nr_customer);
@@ -350,7 +395,7 @@ vector<int> WorstTravelTimeDestroyOperator::operator()() {
 			for (int customer_id : route) {
 				// Add arc TO customer
 				int load_level = this->solution_obj.load_levels[customer_id];
-				double travel_time = data.time_cube[load_level][prev_customer_id + 1][customer_id + 1];
+				double travel_time = data.time_cube(load_level, prev_customer_id + 1, customer_id + 1);
 				travel_times[customer_id] = travel_time;
 
 				// Add arc FROM customer
@@ -361,7 +406,7 @@ vector<int> WorstTravelTimeDestroyOperator::operator()() {
 			}
 
 			// Add last customer -> depot
-			travel_times[prev_customer_id] += data.time_cube[0][prev_customer_id + 1][0];
+			travel_times[prev_customer_id] += data.time_cube(0, prev_customer_id + 1, 0);
 		}
 	}
 
@@ -371,49 +416,38 @@ vector<int> WorstTravelTimeDestroyOperator::operator()() {
 
 	// Perform randomization!
 		// uniform distribution
-	int rnd_int = tools::rand_number_normal(this->mean_removal, this->mean_removal / 2);
+	int rnd_int = this->random_generator.rand_number_normal(this->mean_removal, this->mean_removal / 2);
 	rnd_int = max(0, min(data.nr_customer - 1, rnd_int));
 
 	vector<double> skewed_travel_ranks(travel_time_ranks.size());
 
 	for (unsigned int i = 0; i < travel_time_ranks.size(); i++) {
-		double bias = std::pow(UNI, this->rnd_factor);
+		double bias = std::pow(this->random_generator.uniform(), this->rnd_factor);
 		skewed_travel_ranks[i] = travel_time_ranks[i]*bias;
 	}
 
 	vector<int> sorted_indices = tools::sort_indices(skewed_travel_ranks);
 
 	// return removed customers (increasing order -> take back)
-	vector<int> removed_customers(sorted_indices.end() - rnd_int, sorted_indices.end());
-
-	// 3) Remove customers! (with use of chromosomes)
-	for (int customer_id : removed_customers) {
-		int route_id = solution_obj.route_chromosome[customer_id];
-
-		// We dont know the correct position
-		// Reason for that is because each insertion requires updating
-		// The position tracking. We assume that checking it dynamically
-		// is more efficient
-		vector<int> &route = solution_obj.solution_representation[route_id];
-		int customer_pos = route_evaluate::get_customer_pos(route, customer_id);
-		tools::remove_at(this->solution_obj.solution_representation[route_id], customer_pos);
-	}
+	removed_customers.assign(sorted_indices.end() - rnd_int, sorted_indices.end());
 
-	this->solution_obj.evaluate_solution(this->capa_error_weight, this->frame_error_weight);
-	return removed_customers;
+	// 3) Remove customers! (batched, the positions are tracked by the solution)
+	this->solution_obj.remove_customers(removed_customers, this->capa_error_weight, this->frame_error_weight);
 }
 
-vector<int> WorstRemovalDestroyOperator::operator()() {
+void WorstRemovalDestroyOperator::operator()(vector<int> &removed_customers) {
 	ALNSData &data = this->solution_obj.data_obj.get();
 
 	// 0) Setup
-	int nr_removed_customers = tools::rand_number_normal(this->mean_removal, this->mean_removal / 2);
+	int nr_removed_customers = this->random_generator.rand_number_normal(this->mean_removal, this->mean_removal / 2);
 	nr_removed_customers = max(0, min(data.nr_customer - 1, nr_removed_customers));
-	vector<int> removed_customers;
+	removed_customers.clear();
 	removed_customers.reserve(nr_removed_customers);
 
-	vector<int> candidates = tools::range(data.nr_customer);
-
+	// (buffers of the scratch arena)
+	vector<int> &candidates = this->scratch.candidates;
+	candidates.resize(data.nr_customer);
+	std::iota(candidates.begin(), candidates.end(), 0);
 
 	// 1) Calculate best info on customer and route basis
 	double overall_max_diff = -std::numeric_limits<double>::max();
@@ -421,7 +455,8 @@ vector<int> WorstRemovalDestroyOperator::operator()() {
 	int best_route_id = 0;
 	int best_rem_pos = 0;
 
-	vector<vector<tuple<double, int>>> best_removals(data.nr_customer, vector<tuple<double, int>>(data.nr_vehicles));
+	vector<vector<tuple<double, int>>> &best_removals = this->scratch.route_removals;
+	OperatorScratch::reset_rows(best_removals, data.nr_customer, data.nr_vehicles, tuple<double, int>());
 
 	for (unsigned int customer_id_pos = 0; customer_id_pos < candidates.size(); customer_id_pos++) {
 		for (int route_id = 0; route_id < data.nr_vehicles; route_id++) {
@@ -440,7 +475,7 @@ vector<int> WorstRemovalDestroyOperator::operator()() {
 					route_id,
 					pos);
 
-				double bias = std::pow(UNI, this->rnd_factor);
+				double bias = std::pow(this->random_generator.uniform(), this->rnd_factor);
 				tmp_cost *= bias;
 
 				// perform comparision
@@ -469,7 +504,8 @@ vector<int> WorstRemovalDestroyOperator::operator()() {
 
 		// 2.2) Remove candidate
 		tools::remove_at(candidates, best_customer_id_pos);
-		tools::remove_at(best_removals, best_customer_id_pos);
+		// (the row is moved behind the used rows -> its memory is kept)
+		std::rotate(best_removals.begin() + best_customer_id_pos, best_removals.begin() + best_customer_id_pos + 1, best_removals.end());
 
 		// 2.3) Reevaluate removal costs for that route
 
@@ -486,7 +522,7 @@ vector<int> WorstRemovalDestroyOperator::operator()() {
 					best_route_id,
 					pos);
 
-				double bias = std::pow(UNI, this->rnd_factor);
+				double bias = std::pow(this->random_generator.uniform(), this->rnd_factor);
 				tmp_cost *= bias;
 
 				if (max_diff < tmp_cost) {
@@ -511,7 +547,6 @@ vector<int> WorstRemovalDestroyOperator::operator()() {
 		}
 	}
 
-	return removed_customers;
 }
 
 /**
@@ -524,7 +559,7 @@ Annotation:
 	This is why we use the general randomness factor
 
 */
-vector<int> NodePairDestroyOperator::operator()() {
+void NodePairDestroyOperator::operator()(vector<int> &removed_customers) {
 	// 1) Get the best values of all operators
 	ALNSData &data = this->solution_obj.data_obj.get();
 
@@ -536,18 +571,18 @@ vector<int> NodePairDestroyOperator::operator()() {
 		if (route.size() > 0) {
 			for (int customer_id : route) {
 				// preceeding route potential
-				historic_perf[customer_id] += this->node_pair_potential_matrix[prev_customer_id + 1][customer_id + 1];
+				historic_perf[customer_id] += this->historic_matrices.get_potential(prev_customer_id + 1, customer_id + 1);
 
 				if (prev_customer_id > -1) {
 					// succeeding route
-					historic_perf[prev_customer_id] += this->node_pair_potential_matrix[prev_customer_id + 1][customer_id + 1];
+					historic_perf[prev_customer_id] += this->historic_matrices.get_potential(prev_customer_id + 1, customer_id + 1);
 				}
 
 				prev_customer_id = customer_id;
 			}
 
 			// route potential for the last node -> depot
-			historic_perf[prev_customer_id] += this->node_pair_potential_matrix[prev_customer_id + 1][0];
+			historic_perf[prev_customer_id] += this->historic_matrices.get_potential(prev_customer_id + 1, 0);
 		}
 	}
 
@@ -556,14 +591,14 @@ vector<int> NodePairDestroyOperator::operator()() {
 	vector<int> performance_ranks = tools::get_ranks(historic_perf);
 
 	// 2.2) Decide on number of removed customers
-	int rnd_int = tools::rand_number_normal(this->mean_removal, this->mean_removal / 2);
+	int rnd_int = this->random_generator.rand_number_normal(this->mean_removal, this->mean_removal / 2);
 	rnd_int = max(0, min(data.nr_customer - 1, rnd_int));
 
 	// 2.3) Perform randomization
 	vector<double> skewed_perf_ranks(performance_ranks.size());
 
 	for (unsigned int i = 0; i < performance_ranks.size(); i++) {
-		double bias = std::pow(UNI, this->rnd_factor);
+		double bias = std::pow(this->random_generator.uniform(), this->rnd_factor);
 		skewed_perf_ranks[i] = performance_ranks[i]*bias;
 	}
 
@@ -571,102 +606,89 @@ vector<int> NodePairDestroyOperator::operator()() {
 	vector<int> sorted_indices = tools::sort_indices(skewed_perf_ranks);
 
 	// return removed customers (increasing order -> take back)
-	vector<int> removed_customers(sorted_indices.end() - rnd_int, sorted_indices.end());
+	removed_customers.assign(sorted_indices.end() - rnd_int, sorted_indices.end());
 
-	// 3) Remove customers! (with use of chromosomes)
-	for (int customer_id : removed_customers) {
-		int route_id = solution_obj.route_chromosome[customer_id];
-
-		// We dont know the correct position
-		// Reason for that is because each insertion requires updating
-		// The position tracking. We assume that checking it dynamically
-		// is more efficient
-		vector<int> &route = solution_obj.solution_representation[route_id];
-		int customer_pos = route_evaluate::get_customer_pos(route, customer_id);
-		tools::remove_at(this->solution_obj.solution_representation[route_id], customer_pos);
-	}
-
-	this->solution_obj.evaluate_solution(this->capa_error_weight, this->frame_error_weight);
-	return removed_customers;
+	// 3) Remove customers! (batched, the positions are tracked by the solution)
+	this->solution_obj.remove_customers(removed_customers, this->capa_error_weight, this->frame_error_weight);
 }
 
 /**
 Implementation of the shaw removal operator as described in Shaw (1998) and Ropke & Pissinger (2005)
+
+Granular neighbourhood (if candidate lists are set):
+	The related customer is only selected from the candidates of the random removed customer.
+	If all of them are already removed, all remaining customers are considered.
 */
-vector<int> ShawDestroyOperator::operator()() {
+void ShawDestroyOperator::operator()(vector<int> &removed_customers) {
 	ALNSData &data = this->solution_obj.data_obj.get();
 
 	// 1) initialize removal list
-	int nr_removed_customers = tools::rand_number_normal(this->mean_removal, this->mean_removal / 2);
+	int nr_removed_customers = this->random_generator.rand_number_normal(this->mean_removal, this->mean_removal / 2);
 	nr_removed_customers = max(0, min(data.nr_customer - 1, nr_removed_customers));
 
 	// 1.2) Setup lists
 	vector<int> candidates = tools::range(data.nr_customer);
-	vector<int> removed_customers;
+	vector<bool> is_removed(data.nr_customer, false);
+	removed_customers.clear();
 	removed_customers.reserve(nr_removed_customers);
 
 	// 1.3) Get random customer as start
-	int customer_id = tools::rand_number(data.nr_customer-1);
+	int customer_id = this->random_generator.rand_number(data.nr_customer-1);
 	removed_customers.push_back(customer_id);
-	tools::remove_at(candidates, customer_id);
+	is_removed[customer_id] = true;
 
 	// 2) Iteratively select new customer and push to list
 	int rnd_customer_id;
-	int related_cust_id_pos;
+	int related_cust_id;
 	double max_relatedness;
 
 	for (int i = 1; i < nr_removed_customers; i++) {
 		max_relatedness = std::numeric_limits<double>::max();
+		related_cust_id = -1;
 
 		// 2.1) Get random id
-		rnd_customer_id = removed_customers[tools::rand_number(i-1)];
+		rnd_customer_id = removed_customers[this->random_generator.rand_number(i-1)];
 
 		// 2.2) Find related customer
-		for (unsigned int cand_pos = 0; cand_pos < candidates.size(); cand_pos++) {
-			int cand_id = candidates[cand_pos];
-
-			// 2.2.1) Get relatedness and perform permutation
-			// The distance matrix also includes the depot -> add +1!
-			double relatedness = this->distance_weight*this->norm_distance_matrix[rnd_customer_id+1][cand_id+1]
-				+ this->window_weight*this->norm_start_window_matrix[rnd_customer_id][cand_id]
-				+ this->window_weight*this->norm_end_window_matrix[rnd_customer_id][cand_id]
-				+ this->demand_weight*this->norm_demand_matrix[rnd_customer_id][cand_id];
-
-			// Check if its the same route
-			if (this->solution_obj.route_chromosome[cand_id] == this->solution_obj.route_chromosome[cand_id]) {
-				relatedness += this->vehicle_weight;
-			}
+		// (granular: first only the candidates of the random customer, then all remaining)
+		for (int pass = 0; (pass < 2) && (related_cust_id < 0); pass++) {
+			const vector<int> &neighbours = ((pass == 0) && !data.candidate_lists.empty()) ? data.candidate_lists[rnd_customer_id] : candidates;
+
+			for (int cand_id : neighbours) {
+				if (is_removed[cand_id]) {
+					continue;
+				}
 
-			// 2.2.2) Perform permutation
-			relatedness *= std::pow(UNI, this->rnd_factor);
+				// 2.2.1) Get relatedness and perform permutation
+				// The distances also include the depot -> add +1!
+				double relatedness = this->distance_weight*data.get_norm_distance(rnd_customer_id+1, cand_id+1)
+					+ this->window_weight*data.get_norm_start_window(rnd_customer_id, cand_id)
+					+ this->window_weight*data.get_norm_end_window(rnd_customer_id, cand_id)
+					+ this->demand_weight*data.get_norm_demand(rnd_customer_id, cand_id);
 
-			// 2.2.3) Compare maximum relatedness means a relatedness score of 0!
-			if (relatedness < max_relatedness) {
-				max_relatedness = relatedness;
-				related_cust_id_pos = cand_pos;
+				// Check if its the same route
+				if (this->solution_obj.route_chromosome[cand_id] == this->solution_obj.route_chromosome[cand_id]) {
+					relatedness += this->vehicle_weight;
+				}
+
+				// 2.2.2) Perform permutation
+				relatedness *= std::pow(this->random_generator.uniform(), this->rnd_factor);
+
+				// 2.2.3) Compare maximum relatedness means a relatedness score of 0!
+				if (relatedness < max_relatedness) {
+					max_relatedness = relatedness;
+					related_cust_id = cand_id;
+				}
 			}
 		}
 
 		// 2.3) Add related customer
-		removed_customers.push_back(candidates[related_cust_id_pos]);
-		tools::remove_at(candidates, related_cust_id_pos);
-	}
-
-	// 3) Remove customers! (with use of chromosomes)
-	for (int customer_id : removed_customers) {
-		int route_id = solution_obj.route_chromosome[customer_id];
-
-		// We dont know the correct position
-		// Reason for that is because each insertion requires updating
-		// The position tracking. We assume that checking it dynamically
-		// is more efficient
-		vector<int> &route = solution_obj.solution_representation[route_id];
-		int customer_pos = route_evaluate::get_customer_pos(route, customer_id);
-		tools::remove_at(this->solution_obj.solution_representation[route_id], customer_pos);
+		removed_customers.push_back(related_cust_id);
+		is_removed[related_cust_id] = true;
 	}
 
-	this->solution_obj.evaluate_solution(this->capa_error_weight, this->frame_error_weight);
-	return removed_customers;
+	// 3) Remove customers! (batched, the positions are tracked by the solution)
+	this->solution_obj.remove_customers(removed_customers, this->capa_error_weight, this->frame_error_weight);
 }
 
 /**
@@ -680,9 +702,9 @@ vector<int> ShawDestroyOperator::operator()() {
 		- Effcient peice vise reevaluation is applied
 
 */
-void BasicGreedyInsertionOperator::operator()(std::vector<int> removed_customers) {
+void BasicGreedyInsertionOperator::operator()(std::vector<int> &removed_customers) {
 	for (int customer_id : removed_customers) {
-		tuple<double, int, int> best_insertion = get_best_insertion(customer_id, this->solution_obj, this->capa_error_weight, this->frame_error_weight);
+		tuple<double, int, int> best_insertion = get_best_insertion(customer_id, this->solution_obj, this->capa_error_weight, this->frame_error_weight, this->scratch);
 
 		// perform insertion
 		int best_route_id = std::get<1>(best_insertion);
@@ -695,14 +717,17 @@ void BasicGreedyInsertionOperator::operator()(std::vector<int> removed_customers
 		// reevaluate solution
 		solution_obj.evaluate_change(best_route_id, best_route_pos, capa_error_weight, frame_error_weight);
 	}	
+
+	// all customers are inserted (see RepairOperator)
+	removed_customers.clear();
 }
 
-void RandomGreedyInsertionOperator::operator()(std::vector<int> removed_customers) {
+void RandomGreedyInsertionOperator::operator()(std::vector<int> &removed_customers) {
 	while (removed_customers.size() > 0) {
 		// setup iteration
-		int customer_pos = tools::rand_number(removed_customers.size()-1);
+		int customer_pos = this->random_generator.rand_number(removed_customers.size()-1);
 		int customer_id = removed_customers[customer_pos];
-		tuple<double, int, int> best_insertion = get_best_insertion(customer_id, this->solution_obj, this->capa_error_weight, this->frame_error_weight);
+		tuple<double, int, int> best_insertion = get_best_insertion(customer_id, this->solution_obj, this->capa_error_weight, this->frame_error_weight, this->scratch);
 
 		// perform insertion
 		int best_route_id = std::get<1>(best_insertion);
@@ -721,52 +746,115 @@ void RandomGreedyInsertionOperator::operator()(std::vector<int> removed_customer
 }
 
 /**
- # TODO
-	 Deep greedy checks for each customer at each position whats the best insertion point
-	 It is dominant in the solutions that it can find compared to basic greedy.
-	 However, it is also a computationally more demanding.
+	Check if the cached best insertion of a customer into a route can change
+	by the insertion of another customer into that route
+
+	A route without any position stays without a position if
+		- the capacity check failed (the route load only increases)
+		- the route had no candidate and the new customer is no candidate either
+	All other positions can change (shifted loads in front of the insertion
+	position, delays behind it) -> must be recomputed.
+*/
+bool is_insertion_affected(
+	const tuple<double, int, int> &cached_insertion,
+	int customer_id,
+	int inserted_customer_id,
+	const ALNSData &data)
+{
+	if (std::get<0>(cached_insertion) < std::numeric_limits<double>::max()) {
+		return true;
+	}
+	return !data.candidate_lists.empty() && data.candidate_matrix[customer_id][inserted_customer_id];
+}
+
+/**
+	Get the route of the best insertion of a customer (first route among equal costs)
+*/
+int get_best_route(const vector<tuple<double, int, int>> &best_ins) {
+	int best_route_id = 0;
+	for (unsigned int route_id = 1; route_id < best_ins.size(); route_id++) {
+		if (std::get<0>(best_ins[best_route_id]) > std::get<0>(best_ins[route_id])) {
+			best_route_id = route_id;
+		}
+	}
+	return best_route_id;
+}
 
-	 1) Calculate all insertion positions
+/**
+	Update the route of the best insertion of a customer after the insertion
+	into [changed_route_id] was recomputed (see get_best_route)
+*/
+void update_best_route(
+	const vector<tuple<double, int, int>> &best_ins,
+	int changed_route_id,
+	int &best_route_id)
+{
+	if (changed_route_id == best_route_id) {
+		// might have become worse -> check all routes
+		best_route_id = get_best_route(best_ins);
+	}
+	else if ((std::get<0>(best_ins[best_route_id]) > std::get<0>(best_ins[changed_route_id]))
+		|| ((std::get<0>(best_ins[best_route_id]) == std::get<0>(best_ins[changed_route_id])) && (changed_route_id < best_route_id))) {
+		best_route_id = changed_route_id;
+	}
+}
+
+/**
+	Deep greedy checks for each customer at each position whats the best insertion point
+	It is dominant in the solutions that it can find compared to basic greedy.
+	However, it is also a computationally more demanding.
+
+	 1) Calculate all insertion positions (best per customer and route)
 	 2) Perform best insertion
-	 3) Remove inserted customer from list
-	 4) Reevaluate all insertion positions before and after previous insertion
-	 5) Get best insertion position and start from 2)
+	 3) Remove inserted customer from the heap
+	 4) Reevaluate the insertion positions in the changed route (only if affected)
+	 5) Get best insertion position (heap) and start from 2)
+
+	Annotation:
+		The customers are kept in an indexed heap on their best insertion cost
+		-> no rescan of all customers and routes after each insertion.
+		Ties are resolved as by a scan (first customer, first route).
 */
-void DeepGreedyInsertionOperator::operator()(std::vector<int> removed_customers) {
+void DeepGreedyInsertionOperator::operator()(std::vector<int> &removed_customers) {
 	// Annotation: node_id = customer_id +1
 	ALNSData &data = this->solution_obj.data_obj.get();
+	const int nr_removed = removed_customers.size();
 
+	// 1) Calculate best info on customer and route basis (buffers of the scratch arena)
 	// insertion: cost, route_id, position
-	tuple<double, int, int> best_insertion(std::numeric_limits<double>::max(), 0, 0);
-	int best_customer_id_pos = 0; // Position in the removed customers list
-
-	// 1) Calculate best info on customer and route basis
-	vector<vector<tuple<double, int, int>>> best_insertions(removed_customers.size(), vector<tuple<double, int, int>>(data.nr_vehicles));
-
-	tuple<double, int, int> insertion;
-	for (unsigned int customer_id_pos = 0; customer_id_pos < removed_customers.size(); customer_id_pos++) {
-
+	vector<vector<tuple<double, int, int>>> &best_insertions = this->scratch.route_insertions;
+	OperatorScratch::reset_rows(best_insertions, nr_removed, data.nr_vehicles, tuple<double, int, int>());
+	vector<int> &best_route_ids = this->scratch.best_route_ids;
+	best_route_ids.assign(nr_removed, 0);
+	IndexedHeap &best_customers = this->scratch.best_customers; // key: negated cost -> min cost on top
+	best_customers.reset(nr_removed);
+
+	for (int customer_id_pos = 0; customer_id_pos < nr_removed; customer_id_pos++) {
 		for (int route_id = 0; route_id < data.nr_vehicles; route_id++) {
-			insertion = get_best_insertion(
+			best_insertions[customer_id_pos][route_id] = get_best_insertion(
 				removed_customers[customer_id_pos],
 				solution_obj,
 				capa_error_weight,
 				frame_error_weight,
+				this->scratch,
 				route_id);
-
-			best_insertions[customer_id_pos][route_id] = insertion;
-
-			if (std::get<0>(best_insertion) > std::get<0>(insertion)) {
-				best_insertion = insertion;
-				best_customer_id_pos = customer_id_pos;
-			}
 		}
+		best_route_ids[customer_id_pos] = get_best_route(best_insertions[customer_id_pos]);
+		best_customers.set(customer_id_pos, -std::get<0>(best_insertions[customer_id_pos][best_route_ids[customer_id_pos]]));
 	}
 
 	// 2) Iteratively perform insertions with prev information
-	while (removed_customers.size() > 0) {
+	while (!best_customers.empty()) {
 		// 2.1) perform insertion
+		int best_customer_id_pos = best_customers.top();
 		int best_customer_id = removed_customers[best_customer_id_pos];
+		tuple<double, int, int> best_insertion = best_insertions[best_customer_id_pos][best_route_ids[best_customer_id_pos]];
+
+		// No route has a candidate position (granular neighbourhood) -> search all routes
+		if (std::get<0>(best_insertion) == std::numeric_limits<double>::max()) {
+			best_insertion = get_best_insertion(best_customer_id, solution_obj, capa_error_weight, frame_error_weight, this->scratch);
+		}
+
 		int best_route_id = std::get<1>(best_insertion);
 		int best_route_pos = std::get<2>(best_insertion);
 
@@ -778,37 +866,56 @@ void DeepGreedyInsertionOperator::operator()(std::vector<int> removed_customers)
 
 		this->solution_obj.evaluate_change(best_route_id, best_route_pos, this->capa_error_weight, this->frame_error_weight);
 
-		// 2.2) ) Remove customer from list
-		tools::remove_at(removed_customers, best_customer_id_pos);
-		tools::remove_at(best_insertions, best_customer_id_pos);
+		// 2.2) ) Remove customer from the heap
+		best_customers.remove(best_customer_id_pos);
 
-		// 2.3) Reevaluate the values of the changed route again. (skip if vector is empty)
-		for (unsigned int customer_id_pos = 0; customer_id_pos < removed_customers.size(); customer_id_pos++) {
-			// Check for insertion for entire route (insertion and add load can fuck up windows)
-			insertion = get_best_insertion(
+		// 2.3) Reevaluate the values of the changed route again (insertion and add load can fuck up windows)
+		for (int customer_id_pos = 0; customer_id_pos < nr_removed; customer_id_pos++) {
+			if (!best_customers.contains(customer_id_pos)
+				|| !is_insertion_affected(best_insertions[customer_id_pos][best_route_id], removed_customers[customer_id_pos], best_customer_id, data)) {
+				continue;
+			}
+
+			best_insertions[customer_id_pos][best_route_id] = get_best_insertion(
 				removed_customers[customer_id_pos],
 				solution_obj,
 				capa_error_weight,
 				frame_error_weight,
+				this->scratch,
 				best_route_id);
 
-			best_insertions[customer_id_pos][best_route_id] = insertion;
+			// 2.4) Update the best insertion of the customer
+			update_best_route(best_insertions[customer_id_pos], best_route_id, best_route_ids[customer_id_pos]);
+			best_customers.set(customer_id_pos, -std::get<0>(best_insertions[customer_id_pos][best_route_ids[customer_id_pos]]));
 		}
+	}
 
-		best_insertion = tuple<double, int, int>(std::numeric_limits<double>::max(), 0, 0);
+	// all customers are inserted (see RepairOperator)
+	removed_customers.clear();
+}
 
-		// 2.4) Get the next best insertion customer and position!
-		for (unsigned int customer_id_pos = 0; customer_id_pos < removed_customers.size(); customer_id_pos++) {
-			for (int route_id = 0; route_id < data.nr_vehicles; route_id++) {
-				if (get<0>(best_insertion) > get<0>(best_insertions[customer_id_pos][route_id])) {
-					best_insertion = best_insertions[customer_id_pos][route_id];
-					best_customer_id_pos = customer_id_pos;
-				}
-			}
-		}
+/**
+	Get the regret value of a customer on basis of its best insertion per route
+
+	@param k_best	tmp buffer (size k)
+	@return			regret, route_id, route_pos of the best insertion
+					(route -1 -> no route has a candidate position)
+*/
+tuple<double, int, int> get_regret_insertion(
+	const vector<tuple<double, int, int>> &best_ins,
+	vector<tuple<double, int, int>> &k_best)
+{
+	// Save the k best into a new vector
+	std::partial_sort_copy(best_ins.begin(), best_ins.end(), k_best.begin(), k_best.end(), less<tuple<double, int, int>>());
+
+	double regret = 0;
+	for (unsigned int k = 1; k < k_best.size(); k++) {
+		regret += std::get<0>(k_best[k]) - std::get<0>(k_best[k - 1]);
 	}
-}
 
+	bool found = std::get<0>(k_best[0]) < std::numeric_limits<double>::max();
+	return tuple<double, int, int>(regret, found ? std::get<1>(k_best[0]) : -1, std::get<2>(k_best[0]));
+}
 
 /**
 	Implementation of the KRegretInsertionOperator
@@ -818,65 +925,63 @@ void DeepGreedyInsertionOperator::operator()(std::vector<int> removed_customers)
 	Smart regret layout:
 	1) Calculate all regret values for all customers (with best k insertions)
 	2) Perform insertion
-	3) Reevaluate possible insertion positions (before and after prev. insertion)
-	4) Adjust prioritiy queues if necessary
-	5) Reevaluate regret value if necessary
+	3) Reevaluate possible insertion positions in the changed route (only if affected)
+	4) Reevaluate regret value if necessary
+	5) Adjust the priority queue (indexed heap on the regret values)
 	6) Perform next insertion
 
 	-> Almost O(N)!!
 */
-void KRegretInsertionOperator::operator()(std::vector<int> removed_customers) {
+void KRegretInsertionOperator::operator()(std::vector<int> &removed_customers) {
 	ALNSData &data = this->solution_obj.data_obj.get();
+	const int nr_removed = removed_customers.size();
 
-	int best_customer_id_pos = 0; // Position in the removed customers list
-	// regret, route_id, route_pos
-	tuple<double, int, int> best_insertion(-std::numeric_limits<double>::max(), 0, 0);
+	// 1) Calculate best info on customer and route basis (buffers of the scratch arena)
+	vector<vector<tuple<double, int, int>>> &best_insertions = this->scratch.route_insertions;
+	OperatorScratch::reset_rows(best_insertions, nr_removed, data.nr_vehicles, tuple<double, int, int>());
 
-	// 1) Calculate best info on customer and route basis
-	vector<vector<tuple<double, int, int>>> best_insertions(removed_customers.size(), vector<tuple<double, int, int>>(data.nr_vehicles));
+	// regret, route_id, route_pos (per customer) and the heap on the regret values
+	vector<tuple<double, int, int>> &regret_insertions = this->scratch.regret_insertions;
+	regret_insertions.assign(nr_removed, tuple<double, int, int>());
+	IndexedHeap &best_customers = this->scratch.best_customers;
+	best_customers.reset(nr_removed);
 
 	// 1.1) Get best insertion positions
-	vector<tuple<double, int, int>> k_best(this->k_regret); // tmp allocation
-	tuple<double, int, int> insertion;
-	for (unsigned int customer_id_pos = 0; customer_id_pos < removed_customers.size(); customer_id_pos++) {
+	vector<tuple<double, int, int>> &k_best = this->scratch.k_best; // tmp (size k)
+	k_best.assign(this->k_regret, tuple<double, int, int>());
+	for (int customer_id_pos = 0; customer_id_pos < nr_removed; customer_id_pos++) {
 		for (int route_id = 0; route_id < data.nr_vehicles; route_id++) {
-
-			insertion = get_best_insertion(
+			best_insertions[customer_id_pos][route_id] = get_best_insertion(
 				removed_customers[customer_id_pos],
 				solution_obj,
 				capa_error_weight,
 				frame_error_weight,
+				this->scratch,
 				route_id);
-
-			best_insertions[customer_id_pos][route_id] = insertion;
 		}
 
 		// 1.2) Get regret values
-		double regret = 0;
-		vector<tuple<double, int, int>> &best_ins = best_insertions[customer_id_pos];
-		// Save the k best into a new vector
-		std::partial_sort_copy(best_ins.begin(), best_ins.end(), k_best.begin(), k_best.end(), less<tuple<double, int, int>>());
-
-		for (int k = 1; k < this->k_regret; k++) {
-			regret += std::get<0>(k_best[k]) - std::get<0>(k_best[k - 1]);
-		}
-
-		// 1.3) Get best ins pos
-		if (regret > std::get<0>(best_insertion)) {
-			best_insertion = tuple<double, int, int>(regret, std::get<1>(k_best[0]), std::get<2>(k_best[0]));
-			best_customer_id_pos = customer_id_pos; // Position in the removed customers list
-		}
+		regret_insertions[customer_id_pos] = get_regret_insertion(best_insertions[customer_id_pos], k_best);
+		best_customers.set(customer_id_pos, std::get<0>(regret_insertions[customer_id_pos]));
 	}
 
 
 	// 2) Perform insertion and reevaluate
-	while (removed_customers.size() > 0) {
+	while (!best_customers.empty()) {
+		// 2.1) Perform insertion (highest regret, first customer on ties)
+		int best_customer_id_pos = best_customers.top();
+		int best_customer_id = removed_customers[best_customer_id_pos];
+		tuple<double, int, int> best_insertion = regret_insertions[best_customer_id_pos];
+
+		// No route has a candidate position (granular neighbourhood) -> search all routes
+		if (std::get<1>(best_insertion) < 0) {
+			tuple<double, int, int> insertion_all = get_best_insertion(best_customer_id, solution_obj, capa_error_weight, frame_error_weight, this->scratch);
+			best_insertion = tuple<double, int, int>(std::get<0>(best_insertion), std::get<1>(insertion_all), std::get<2>(insertion_all));
+		}
+
 		int best_route_id = std::get<1>(best_insertion);
 		int best_route_pos = std::get<2>(best_insertion);
 
-		// 2.1) Perform insertion
-		int best_customer_id = removed_customers[best_customer_id_pos];
-
 		vector<int> &route = this->solution_obj.solution_representation[best_route_id];
 		route.insert(route.begin() + best_route_pos, best_customer_id);
 		this->solution_obj.route_chromosome[best_customer_id] = best_route_id;
@@ -884,42 +989,35 @@ void KRegretInsertionOperator::operator()(std::vector<int> removed_customers) {
 		// reevaluate solution
 		this->solution_obj.evaluate_change(best_route_id, best_route_pos, this->capa_error_weight, this->frame_error_weight);
 
-		// 2.2) Remove customer from list
-		tools::remove_at(removed_customers, best_customer_id_pos);
-		tools::remove_at(best_insertions, best_customer_id_pos);
+		// 2.2) Remove customer from the heap
+		best_customers.remove(best_customer_id_pos);
 
 
-		// 2.3) Reevaluate the values of the changed route again. (skip if vector is empty)
+		// 2.3) Reevaluate the values of the changed route again
 		int changed_route_id = best_route_id;
 
-		best_insertion = tuple<double, int, int>(-std::numeric_limits<double>::max(), 0, 0);
-		for (unsigned int customer_id_pos = 0; customer_id_pos < removed_customers.size(); customer_id_pos++) {
+		for (int customer_id_pos = 0; customer_id_pos < nr_removed; customer_id_pos++) {
+			if (!best_customers.contains(customer_id_pos)
+				|| !is_insertion_affected(best_insertions[customer_id_pos][changed_route_id], removed_customers[customer_id_pos], best_customer_id, data)) {
+				continue;
+			}
 
-			insertion = get_best_insertion(
+			best_insertions[customer_id_pos][changed_route_id] = get_best_insertion(
 				removed_customers[customer_id_pos],
 				solution_obj,
 				capa_error_weight,
 				frame_error_weight,
+				this->scratch,
 				changed_route_id);
 
-			best_insertions[customer_id_pos][changed_route_id] = insertion;
-
-			// 2.5) Reevaluate the regret values!
-			double regret = 0;
-			vector<tuple<double, int, int>> &best_ins = best_insertions[customer_id_pos];
-			std::partial_sort_copy(best_ins.begin(), best_ins.end(), k_best.begin(), k_best.end(), less<tuple<double, int, int>>());
-
-			for (int k = 1; k < this->k_regret; k++) {
-				regret += std::get<0>(k_best[k]) - std::get<0>(k_best[k - 1]);
-			}
-
-			// 2.6) Get best ins pos
-			if (regret > std::get<0>(best_insertion)) {
-				best_insertion = tuple<double, int, int>(regret, std::get<1>(k_best[0]), std::get<2>(k_best[0]));
-				best_customer_id_pos = customer_id_pos; // Position in the removed customers list
-			}
+			// 2.4) Reevaluate the regret values!
+			regret_insertions[customer_id_pos] = get_regret_insertion(best_insertions[customer_id_pos], k_best);
+			best_customers.set(customer_id_pos, std::get<0>(regret_insertions[customer_id_pos]));
 		}
 	}
+
+	// all customers are inserted (see RepairOperator)
+	removed_customers.clear();
 }
 
 /**
@@ -931,13 +1029,13 @@ void KRegretInsertionOperator::operator()(std::vector<int> removed_customers) {
 	2) If no position possible or bigger than beta
 	 2.1) Perform randomized greedy insertion
 */
-void BetaHybridInsertionOperator::operator()(std::vector<int> removed_customers) {
+void BetaHybridInsertionOperator::operator()(std::vector<int> &removed_customers) {
 	tuple<double, int, int> best_insertion(std::numeric_limits<double>::max(), -1, -1);
 
 	// 1) Perform beta insertion if possible
 	if ((removed_customers.size() <= unsigned(beta) ) & (removed_customers.size() > unsigned(0))) {
 		// 1.1) Revert customers list with probability of 0.5
-		if (tools::rand_number(1) == 0) {
+		if (this->random_generator.rand_number(1) == 0) {
 			std::reverse(removed_customers.begin(), removed_customers.end());
 		}
 
@@ -946,22 +1044,22 @@ void BetaHybridInsertionOperator::operator()(std::vector<int> removed_customers)
 			vector<int> &route = this->solution_obj.solution_representation[route_id];
 
 			for (unsigned int ins_pos = 0; ins_pos <= route.size(); ins_pos++) {
-				try {
-					double cost_diff = evaluate_insertion_chain(this->solution_obj,
-						this->capa_error_weight,
-						this->frame_error_weight,
-						route_id,
-						removed_customers,
-						ins_pos) - this->solution_obj.solution_quality;
-
-					if (std::get<0>(best_insertion) > cost_diff) {
-						best_insertion = tuple<double, int, int>(cost_diff, route_id, ins_pos);
-					}
-				}
-				catch (InfeasibilityException) {
-					// Max infeasibility is reached -> not insertable in this route!
+				double quality = evaluate_insertion_chain(this->solution_obj,
+					this->capa_error_weight,
+					this->frame_error_weight,
+					route_id,
+					removed_customers,
+					ins_pos);
+
+				// Max infeasibility is reached -> not insertable in this route!
+				if (quality == std::numeric_limits<double>::max()) {
 					break;
 				}
+
+				double cost_diff = quality - this->solution_obj.solution_quality;
+				if (std::get<0>(best_insertion) > cost_diff) {
+					best_insertion = tuple<double, int, int>(cost_diff, route_id, ins_pos);
+				}
 			}
 		}
 
@@ -990,9 +1088,9 @@ void BetaHybridInsertionOperator::operator()(std::vector<int> removed_customers)
 	if ((std::get<1>(best_insertion) < 0) | (int(removed_customers.size()) > this->beta)) {
 		while (removed_customers.size() > 0) {
 			// setup iteration
-			int customer_pos = tools::rand_number(removed_customers.size() - 1);
+			int customer_pos = this->random_generator.rand_number(removed_customers.size() - 1);
 			int customer_id = removed_customers[customer_pos];
-			best_insertion = get_best_insertion(customer_id, this->solution_obj, this->capa_error_weight, this->frame_error_weight);
+			best_insertion = get_best_insertion(customer_id, this->solution_obj, this->capa_error_weight, this->frame_error_weight, this->scratch);
 
 			// perform insertion
 			int best_route_id = std::get<1>(best_insertion);
@@ -1009,4 +1107,7 @@ void BetaHybridInsertionOperator::operator()(std::vector<int> removed_customers)
 			tools::remove_at(removed_customers, customer_pos);
 		}
 	}
+
+	// all customers are inserted (see RepairOperator)
+	removed_customers.clear();
 }
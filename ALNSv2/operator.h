@@ -5,6 +5,7 @@
 		2) Repair operator
 
 	Every operator must be declared as a functor in order to be useable in the roulette wheel mechanism
+	(the operators are created and owned by the OperatorRegistry, see operator_registry.h)
 
 	Assumption: The route has been reevaluated after the customers are removed
 
@@ -13,6 +14,8 @@
 #include "tools.h"
 #include "alns_data.h"
 #include "solution.h"
+#include "historic_matrices.h"
+#include "operator_scratch.h"
 #include <vector>
 #include <limits>
 
@@ -24,14 +27,22 @@ public:
 	const double &frame_error_weight;
 
 	Solution & solution_obj;
+	tools::RandomGenerator &random_generator; // Owned by the ALNS object
+	OperatorScratch &scratch; // Owned by the ALNS object (see operator_scratch.h)
 
 	explicit Operator(Solution &sol_obj, 
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight, 
 		double &frame_error_weight) 
 		: solution_obj(sol_obj),
+		random_generator(random_generator),
+		scratch(scratch),
 		capa_error_weight(capa_error_weight),
 		frame_error_weight(frame_error_weight)
 	{}
+
+	virtual ~Operator() {}
 };
 
 
@@ -39,22 +50,27 @@ class DestroyOperator : public Operator{
 public:
 	// default constructor for each destroy operator
 	explicit DestroyOperator(Solution & sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight) 
-		: Operator(sol_obj, capa_error_weight, frame_error_weight){}
+		: Operator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight){}
 
-	virtual std::vector<int> operator()() = 0; // return removed customers
+	virtual void operator()(std::vector<int> &removed_customers) = 0; // fills the (cleared) list with the removed customers
 };
 
 
 class RepairOperator : public Operator {
 public:
 	explicit RepairOperator(Solution & sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight)
-		: Operator(sol_obj, capa_error_weight, frame_error_weight) {}
+		: Operator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight) {}
 
-	virtual void operator()(std::vector<int> removed_customers) = 0;
+	// Inserts all removed customers, [removed_customers] is empty afterwards (the next destroy starts from an empty list)
+	virtual void operator()(std::vector<int> &removed_customers) = 0;
 };
 
 /**
@@ -67,13 +83,15 @@ private:
 
 public:
 	RandomDestroyOperator(Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight,
 		const double &mean_rem) :
-		DestroyOperator(sol_obj, capa_error_weight, frame_error_weight),
+		DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
 		mean_removal(mean_rem) {};
 
-	std::vector<int> operator()() override; // TODO
+	void operator()(std::vector<int> &removed_customers) override; // TODO
 };
 
 
@@ -84,11 +102,13 @@ public:
 class RandomRouteDestroyOperator : public DestroyOperator {
 public:
 	RandomRouteDestroyOperator(Solution & sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight) :
-		DestroyOperator(sol_obj, capa_error_weight, frame_error_weight) {}
+		DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight) {}
 
-	std::vector<int> operator()() override; // TODO
+	void operator()(std::vector<int> &removed_customers) override; // TODO
 };
 
 
@@ -104,17 +124,19 @@ private:
 
 public:
 	BiggestDemandDestroyOperator(Solution & sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		std::vector<double> demands,
 		double rnd_factor,
 		double &capa_error_weight,
 		double &frame_error_weight,
 		double &mean_rem)
-		: DestroyOperator(sol_obj, capa_error_weight, frame_error_weight),
+		: DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
 		demand_ranks(tools::get_ranks(demands)),
 		rnd_factor(rnd_factor),
 		mean_removal(mean_rem){};
 
-	std::vector<int> operator()() override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 
@@ -134,15 +156,17 @@ private:
 
 public:
 	WorstTravelTimeDestroyOperator(Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double rnd_factor,
 		double &capa_error_weight,
 		double &frame_error_weight,
 		double &mean_rem) :
-		DestroyOperator(sol_obj, capa_error_weight, frame_error_weight),
+		DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
 		rnd_factor(rnd_factor),
 		mean_removal(mean_rem){};
 
-	std::vector<int> operator()() override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /**
@@ -158,15 +182,17 @@ private:
 
 public:
 	WorstRemovalDestroyOperator(Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double rnd_factor,
 		double &capa_error_weight,
 		double &frame_error_weight,
 		double &mean_rem) :
-		DestroyOperator(sol_obj, capa_error_weight, frame_error_weight),
+		DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
 		rnd_factor(rnd_factor),
 		mean_removal(mean_rem) {};
 
-	std::vector<int> operator()() override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /**
@@ -175,23 +201,25 @@ public:
 */
 class NodePairDestroyOperator : public DestroyOperator {
 private:
-	std::vector<std::vector<double>> &node_pair_potential_matrix;
+	const HistoricMatrices &historic_matrices;
 	const double rnd_factor;
 	double const &mean_removal;
 
 public:
 	NodePairDestroyOperator(Solution &sol_obj,
-		std::vector<std::vector<double>> &node_pair_potential_matrix,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
+		const HistoricMatrices &historic_matrices,
 		double rnd_factor,
 		double &capa_error_weight,
 		double &frame_error_weight,
 		double &mean_rem) :
-		DestroyOperator(sol_obj, capa_error_weight, frame_error_weight),
-		node_pair_potential_matrix(node_pair_potential_matrix),
+		DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
+		historic_matrices(historic_matrices),
 		rnd_factor(rnd_factor),
 		mean_removal(mean_rem) {};
 
-	std::vector<int> operator()() override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /**
@@ -204,23 +232,17 @@ private:
 	const double window_weight;
 	const double demand_weight;
 	const double vehicle_weight;
-	const std::vector<std::vector<double>> &norm_distance_matrix;
-	const std::vector<std::vector<double>> &norm_start_window_matrix;
-	const std::vector<std::vector<double>> &norm_end_window_matrix;
-	const std::vector<std::vector<double>> &norm_demand_matrix;
 	const double rnd_factor;
 	const double &mean_removal;
 
 public:
 	ShawDestroyOperator(Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double distance_weight,
 		double window_weight,
 		double demand_weight,
 		double vehicle_weight,
-		std::vector<std::vector<double>> &norm_distance_matrix,
-		std::vector<std::vector<double>> &norm_start_window_matrix,
-		std::vector<std::vector<double>> &norm_end_window_matrix,
-		std::vector<std::vector<double>> &norm_demand_matrix,
 		double rnd_factor,
 		double &mean_removal,
 		double &capa_error_weight,
@@ -229,15 +251,11 @@ public:
 		window_weight(window_weight),
 		vehicle_weight(vehicle_weight),
 		demand_weight(demand_weight),
-		norm_distance_matrix(norm_distance_matrix),
-		norm_start_window_matrix(norm_start_window_matrix),
-		norm_end_window_matrix(norm_end_window_matrix),
-		norm_demand_matrix(norm_demand_matrix),
 		rnd_factor(rnd_factor),
 		mean_removal(mean_removal),
-		DestroyOperator(sol_obj, capa_error_weight, frame_error_weight) {};
+		DestroyOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight) {};
 
-	std::vector<int> operator()() override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /**
@@ -249,11 +267,13 @@ public:
 	// constructor (Take base info from the ALNS object)
 	BasicGreedyInsertionOperator(
 		Solution & sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight) :
-		RepairOperator(sol_obj, capa_error_weight, frame_error_weight) {}
+		RepairOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight) {}
 
-	void operator()(std::vector<int> removed_customers) override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /**
@@ -265,11 +285,13 @@ public:
 	// constructor
 	RandomGreedyInsertionOperator(
 		Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight):
-		RepairOperator(sol_obj, capa_error_weight, frame_error_weight) {}
+		RepairOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight) {}
 	
-	void operator()(std::vector<int> removed_customers) override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /*
@@ -281,11 +303,13 @@ public:
 	//constructor
 	DeepGreedyInsertionOperator(
 		Solution & sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		double &capa_error_weight,
 		double &frame_error_weight) :
-		RepairOperator(sol_obj, capa_error_weight, frame_error_weight) {}
+		RepairOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight) {}
 
-	void operator()(std::vector<int> removed_customers) override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 
@@ -303,13 +327,15 @@ public:
 	// constructor
 	KRegretInsertionOperator(
 		Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		int k_regret,
 		double &capa_error_weight,
 		double &frame_error_weight) :
-		RepairOperator(sol_obj, capa_error_weight, frame_error_weight),
+		RepairOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
 		k_regret(k_regret) {};
 
-	void operator()(std::vector<int> removed_customers) override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
 
 /*
@@ -324,11 +350,13 @@ private:
 public:
 	BetaHybridInsertionOperator(
 		Solution &sol_obj,
+		tools::RandomGenerator &random_generator,
+		OperatorScratch &scratch,
 		int beta,
 		double &capa_error_weight,
 		double &frame_error_weight) :
-		RepairOperator(sol_obj, capa_error_weight, frame_error_weight),
+		RepairOperator(sol_obj, random_generator, scratch, capa_error_weight, frame_error_weight),
 		beta(beta) {};
 
-	void operator()(std::vector<int> removed_customers) override;
+	void operator()(std::vector<int> &removed_customers) override;
 };
\ No newline at end of file
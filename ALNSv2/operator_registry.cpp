@@ -0,0 +1,278 @@
+/**
+This file contains the operator registry (see operator_registry.h)
+*/
+#include "operator_registry.h"
+#include "operator.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <iostream>
+
+using namespace std;
+
+/**
+Factory of an operator type
+
+All parameters of a name must be listed in [parameter_names] (checked before create)
+*/
+template <typename T>
+struct OperatorType {
+	vector<string> parameter_names;
+	T* (*create)(const OperatorContext &context, const OperatorParameters &parameters);
+};
+
+double get_parameter(const OperatorParameters &parameters, const string &key, double default_value) {
+	OperatorParameters::const_iterator it = parameters.find(key);
+	return (it == parameters.end()) ? default_value : it->second;
+}
+
+/**
+Integer parameter (e.g. k of the k-regret insertion) that must be at least [min_value]
+*/
+int get_int_parameter(const OperatorParameters &parameters, const string &key, int default_value, int min_value) {
+	double value = get_parameter(parameters, key, default_value);
+
+	if ((value != std::floor(value)) || (value < min_value)) {
+		throw invalid_argument("Operator parameter " + key + " must be an integer >= " + to_string(min_value));
+	}
+	return int(value);
+}
+
+ShawDestroyOperator* create_shaw_operator(const OperatorContext &context, const OperatorParameters &parameters) {
+	return new ShawDestroyOperator(
+		context.solution,
+		context.random_generator,
+		context.scratch,
+		get_parameter(parameters, "distance", 9),
+		get_parameter(parameters, "window", 3),
+		get_parameter(parameters, "demand", 2),
+		get_parameter(parameters, "vehicle", 5),
+		get_parameter(parameters, "noise", context.random_noise),
+		context.mean_removal,
+		context.capa_error_weight,
+		context.frame_error_weight);
+}
+
+const map<string, OperatorType<DestroyOperator>>& get_destroy_table() {
+	static const map<string, OperatorType<DestroyOperator>> table = {
+		{ "random_destroy", { {}, [](const OperatorContext &context, const OperatorParameters &) -> DestroyOperator* {
+			return new RandomDestroyOperator(context.solution, context.random_generator, context.scratch,
+				context.capa_error_weight, context.frame_error_weight, context.mean_removal);
+		} } },
+		{ "route_destroy", { {}, [](const OperatorContext &context, const OperatorParameters &) -> DestroyOperator* {
+			return new RandomRouteDestroyOperator(context.solution, context.random_generator, context.scratch,
+				context.capa_error_weight, context.frame_error_weight);
+		} } },
+		{ "demand_destroy", { { "noise" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> DestroyOperator* {
+			return new BiggestDemandDestroyOperator(context.solution, context.random_generator, context.scratch,
+				context.data.demand, get_parameter(parameters, "noise", context.random_noise),
+				context.capa_error_weight, context.frame_error_weight, context.mean_removal);
+		} } },
+		{ "time_destroy", { { "noise" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> DestroyOperator* {
+			return new WorstTravelTimeDestroyOperator(context.solution, context.random_generator, context.scratch,
+				get_parameter(parameters, "noise", context.random_noise),
+				context.capa_error_weight, context.frame_error_weight, context.mean_removal);
+		} } },
+		{ "worst_destroy", { { "noise" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> DestroyOperator* {
+			return new WorstRemovalDestroyOperator(context.solution, context.random_generator, context.scratch,
+				get_parameter(parameters, "noise", context.random_noise),
+				context.capa_error_weight, context.frame_error_weight, context.mean_removal);
+		} } },
+		{ "node_pair_destroy", { { "noise" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> DestroyOperator* {
+			return new NodePairDestroyOperator(context.solution, context.random_generator, context.scratch,
+				context.historic_matrices, get_parameter(parameters, "noise", context.random_noise),
+				context.capa_error_weight, context.frame_error_weight, context.mean_removal);
+		} } },
+		{ "shaw_destroy", { { "distance", "window", "demand", "vehicle", "noise" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> DestroyOperator* {
+			return create_shaw_operator(context, parameters);
+		} } }
+	};
+	return table;
+}
+
+const map<string, OperatorType<RepairOperator>>& get_repair_table() {
+	static const map<string, OperatorType<RepairOperator>> table = {
+		{ "basic_greedy", { {}, [](const OperatorContext &context, const OperatorParameters &) -> RepairOperator* {
+			return new BasicGreedyInsertionOperator(context.solution, context.random_generator, context.scratch,
+				context.capa_error_weight, context.frame_error_weight);
+		} } },
+		{ "random_greedy", { {}, [](const OperatorContext &context, const OperatorParameters &) -> RepairOperator* {
+			return new RandomGreedyInsertionOperator(context.solution, context.random_generator, context.scratch,
+				context.capa_error_weight, context.frame_error_weight);
+		} } },
+		{ "deep_greedy", { {}, [](const OperatorContext &context, const OperatorParameters &) -> RepairOperator* {
+			return new DeepGreedyInsertionOperator(context.solution, context.random_generator, context.scratch,
+				context.capa_error_weight, context.frame_error_weight);
+		} } },
+		{ "k_regret", { { "k" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> RepairOperator* {
+			return new KRegretInsertionOperator(context.solution, context.random_generator, context.scratch,
+				get_int_parameter(parameters, "k", 2, 1),
+				context.capa_error_weight, context.frame_error_weight);
+		} } },
+		{ "beta_hybrid", { { "beta" }, [](const OperatorContext &context, const OperatorParameters &parameters) -> RepairOperator* {
+			return new BetaHybridInsertionOperator(context.solution, context.random_generator, context.scratch,
+				get_int_parameter(parameters, "beta", 3, 0),
+				context.capa_error_weight, context.frame_error_weight);
+		} } }
+	};
+	return table;
+}
+
+map<string, string> OperatorRegistry::get_aliases() {
+	return {
+		{ "distance_similarity", "shaw_destroy(distance=1, window=0, demand=0, vehicle=0)" },
+		{ "window_similarity", "shaw_destroy(distance=0, window=1, demand=0, vehicle=0)" },
+		{ "demand_similarity", "shaw_destroy(distance=0, window=0, demand=1, vehicle=0)" },
+		{ "2_regret", "k_regret(k=2)" },
+		{ "3_regret", "k_regret(k=3)" },
+		{ "5_regret", "k_regret(k=5)" }
+	};
+}
+
+string trim(const string &text) {
+	size_t start = text.find_first_not_of(" \t");
+	if (start == string::npos) {
+		return string();
+	}
+	return text.substr(start, text.find_last_not_of(" \t") - start + 1);
+}
+
+/**
+Parse "<type>(<key>=<value>, ...)"
+The parameters of an alias are overwritten by the parameters of the name.
+*/
+OperatorSpec parse_operator_spec(const string &name) {
+	OperatorSpec spec;
+	size_t open_pos = name.find('(');
+	spec.type = trim(name.substr(0, open_pos));
+
+	if (spec.type.empty()) {
+		throw invalid_argument("Invalid operator name: " + name);
+	}
+
+	if (open_pos != string::npos) {
+		size_t close_pos = name.rfind(')');
+		if ((close_pos == string::npos) || (close_pos < open_pos) || !trim(name.substr(close_pos + 1)).empty()) {
+			throw invalid_argument("Invalid operator name: " + name);
+		}
+
+		string parameter_list = name.substr(open_pos + 1, close_pos - open_pos - 1);
+		size_t start = 0;
+
+		while (!trim(parameter_list).empty() && (start <= parameter_list.size())) {
+			size_t end = parameter_list.find(',', start);
+			if (end == string::npos) {
+				end = parameter_list.size();
+			}
+
+			// key=value
+			string item = parameter_list.substr(start, end - start);
+			size_t assign_pos = item.find('=');
+			string key = trim(item.substr(0, assign_pos));
+			string value_text = (assign_pos == string::npos) ? string() : trim(item.substr(assign_pos + 1));
+
+			size_t nr_parsed = 0;
+			double value = 0;
+			try {
+				value = stod(value_text, &nr_parsed);
+			}
+			catch (const exception &) {
+				nr_parsed = 0;
+			}
+
+			if (key.empty() || value_text.empty() || (nr_parsed != value_text.size()) || spec.parameters.count(key)) {
+				throw invalid_argument("Invalid operator parameter \"" + trim(item) + "\" in " + name);
+			}
+			spec.parameters[key] = value;
+			start = end + 1;
+		}
+	}
+
+	// resolve the alias
+	map<string, string> aliases = OperatorRegistry::get_aliases();
+	map<string, string>::const_iterator alias = aliases.find(spec.type);
+
+	if (alias != aliases.end()) {
+		OperatorSpec alias_spec = parse_operator_spec(alias->second);
+		for (const pair<const string, double> &parameter : spec.parameters) {
+			alias_spec.parameters[parameter.first] = parameter.second;
+		}
+		return alias_spec;
+	}
+	return spec;
+}
+
+/**
+Create the operator of a name from the table of its kind (destroy or repair)
+*/
+template <typename T>
+T* create_operator(const map<string, OperatorType<T>> &table, const OperatorContext &context, const string &name) {
+	OperatorSpec spec = parse_operator_spec(name);
+	typename map<string, OperatorType<T>>::const_iterator type = table.find(spec.type);
+
+	if (type == table.end()) {
+		return nullptr;
+	}
+
+	for (const pair<const string, double> &parameter : spec.parameters) {
+		const vector<string> &parameter_names = type->second.parameter_names;
+		if (find(parameter_names.begin(), parameter_names.end(), parameter.first) == parameter_names.end()) {
+			throw invalid_argument("Unknown parameter " + parameter.first + " of the operator " + name);
+		}
+	}
+	return type->second.create(context, spec.parameters);
+}
+
+OperatorRegistry::OperatorRegistry(const OperatorContext &context,
+	const vector<string> &destroy_names,
+	const vector<string> &repair_names) :
+	destroy_names(destroy_names),
+	repair_names(repair_names)
+{
+	// No operators are passed, use random destroy / basic greedy as default
+	if (this->destroy_names.size() == 0) {
+		cout << "No destroy operator supplied, take random_destroy as default" << endl;
+		this->destroy_names.push_back(string("random_destroy"));
+	}
+	if (this->repair_names.size() == 0) {
+		cout << "No insertion operator supplied, take basic_greedy as default" << endl;
+		this->repair_names.push_back(string("basic_greedy"));
+	}
+
+	for (const string &name : this->destroy_names) {
+		DestroyOperator *op = create_operator(get_destroy_table(), context, name);
+		if (op == nullptr) {
+			throw invalid_argument("At least one of the provided destroy operators unknown: " + name);
+		}
+		this->destroy_operators.push_back(unique_ptr<DestroyOperator>(op));
+	}
+
+	for (const string &name : this->repair_names) {
+		RepairOperator *op = create_operator(get_repair_table(), context, name);
+		if (op == nullptr) {
+			throw invalid_argument("At least one of the provided insertion operators unknown: " + name);
+		}
+		this->repair_operators.push_back(unique_ptr<RepairOperator>(op));
+	}
+}
+
+template <typename T>
+map<string, vector<string>> get_types(const map<string, OperatorType<T>> &table) {
+	map<string, vector<string>> types;
+	for (const pair<const string, OperatorType<T>> &type : table) {
+		types[type.first] = type.second.parameter_names;
+	}
+	return types;
+}
+
+map<string, vector<string>> OperatorRegistry::get_destroy_types() {
+	return get_types(get_destroy_table());
+}
+
+map<string, vector<string>> OperatorRegistry::get_repair_types() {
+	return get_types(get_repair_table());
+}
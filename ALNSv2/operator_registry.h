@@ -0,0 +1,80 @@
+/**
+Registry of the destroy and repair operators of one ALNS object
+
+The operators are created once from their names and are owned by the registry
+-> stable objects (no copies into type erased functors), the wheels only draw an
+operator id and the search calls the operator of that id.
+
+Operator names:
+	<type>							e.g. "random_destroy", "deep_greedy"
+	<type>(<key>=<value>, ...)		parameterised variant, e.g. "shaw_destroy(distance=1, window=0)" or "k_regret(k=4)"
+	<alias>							predefined variant, e.g. "2_regret" = "k_regret(k=2)" (see get_aliases)
+
+Parameters that are not set keep their default (noise: random_noise of the ALNS).
+Unknown types, parameters or malformed names throw std::invalid_argument.
+*/
+#pragma once
+#include "operator.h"
+#include "operator_scratch.h"
+#include "historic_matrices.h"
+#include "alns_data.h"
+#include "solution.h"
+#include "tools.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <memory>
+
+// Objects of the ALNS the operators are bound to (all owned by the ALNS object)
+struct OperatorContext {
+	Solution &solution;
+	tools::RandomGenerator &random_generator;
+	OperatorScratch &scratch;
+	double &capa_error_weight;
+	double &frame_error_weight;
+	double &mean_removal;
+	double random_noise; // default noise of the destroy operators
+	ALNSData &data;
+	const HistoricMatrices &historic_matrices;
+};
+
+typedef std::map<std::string, double> OperatorParameters;
+
+struct OperatorSpec {
+	std::string type;
+	OperatorParameters parameters;
+};
+
+// Parse an operator name and resolve its alias (see above)
+OperatorSpec parse_operator_spec(const std::string &name);
+
+class OperatorRegistry {
+private:
+	std::vector<std::unique_ptr<DestroyOperator>> destroy_operators;
+	std::vector<std::unique_ptr<RepairOperator>> repair_operators;
+	std::vector<std::string> destroy_names;
+	std::vector<std::string> repair_names;
+
+public:
+	OperatorRegistry() {};
+
+	// Create all operators (no names: random_destroy / basic_greedy as default)
+	OperatorRegistry(const OperatorContext &context,
+		const std::vector<std::string> &destroy_names,
+		const std::vector<std::string> &repair_names);
+
+	int nr_destroy_operators() const { return int(this->destroy_operators.size()); }
+	int nr_repair_operators() const { return int(this->repair_operators.size()); }
+
+	DestroyOperator& get_destroy_operator(int operator_id) { return *this->destroy_operators[operator_id]; }
+	RepairOperator& get_repair_operator(int operator_id) { return *this->repair_operators[operator_id]; }
+
+	// Names in the order of the operator ids (wheels and stats)
+	const std::vector<std::string>& get_destroy_names() const { return this->destroy_names; }
+	const std::vector<std::string>& get_repair_names() const { return this->repair_names; }
+
+	// Available types with the names of their parameters and the predefined variants
+	static std::map<std::string, std::vector<std::string>> get_destroy_types();
+	static std::map<std::string, std::vector<std::string>> get_repair_types();
+	static std::map<std::string, std::string> get_aliases();
+};
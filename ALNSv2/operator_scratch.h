@@ -0,0 +1,49 @@
+/**
+Reusable scratch buffers of the operators (scratch arena of one ALNS object)
+
+All operators of an ALNS object run one after another on its running solution
+-> they share one arena instead of allocating their transient containers per call.
+The buffers only grow: clear() / assign() keep the capacity, so after the first
+iterations an operator call does not touch the heap anymore.
+
+Annotation:
+	The contents are only valid within one operator call (any operator may overwrite them).
+	The nested matrices keep all rows ever used. The first [nr_rows] rows are valid
+	after reset_rows, the remaining ones are stale.
+*/
+#pragma once
+#include "solution.h"
+#include "indexed_heap.h"
+#include <vector>
+#include <tuple>
+
+struct OperatorScratch {
+	// best insertion search (see get_best_insertion)
+	InsertionPrefix prefix;
+	std::vector<std::tuple<double, int, int>> best_insertions;
+
+	// customer x route matrices of the deep greedy / k-regret insertion (cost, route_id, route_pos)
+	std::vector<std::vector<std::tuple<double, int, int>>> route_insertions;
+	std::vector<std::tuple<double, int, int>> regret_insertions;	// regret, route_id, route_pos
+	std::vector<std::tuple<double, int, int>> k_best;
+	std::vector<int> best_route_ids;
+	IndexedHeap best_customers;
+
+	// customer x route matrix of the worst removal (cost, route_pos)
+	std::vector<std::vector<std::tuple<double, int>>> route_removals;
+	std::vector<int> candidates;
+
+	/**
+	Set the first [nr_rows] rows of a matrix to [nr_cols] copies of the value
+	(rows are only added, never released)
+	*/
+	template <typename T>
+	static void reset_rows(std::vector<std::vector<T>> &rows, int nr_rows, int nr_cols, const T &value) {
+		if (int(rows.size()) < nr_rows) {
+			rows.resize(nr_rows);
+		}
+		for (int row = 0; row < nr_rows; row++) {
+			rows[row].assign(nr_cols, value);
+		}
+	}
+};
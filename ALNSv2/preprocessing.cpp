@@ -1,9 +1,11 @@
 #include "alns_data.h"
 #include "tools.h"
 #include <math.h>
-#include <iostream> // used for cout
 #include <algorithm> // used for min
 #include <vector> // used to leverage the vector type
+#include <utility> // used for pair
+#include <functional> // used for the row functions
+#include <thread> // used for the parallel preprocessing
 
 using namespace std;
 
@@ -17,46 +19,102 @@ const double RIDER_SURFACE = 0.83;
 const double RHO = 1.18;
 const double COEFFICIENT_ROLLING = 0.01;
 const double AIR_RESISTANCE_CONSTANT = (RHO * DRAG_COEFFICIENT * RIDER_SURFACE) / 2;
+const double DRIVETRAIN_EFFICIENCY = 0.95;
+
+// Define preprocessing constants
+const int NEWTON_STEPS = 6;			// Steps of the velocity solve (machine precision after 5)
+const int NEWTON_STEPS_WARM = 4;	// Steps if started from the previous load level
+const int MIN_ROWS_PER_THREAD = 64;	// Parallel preprocessing only for bigger instances
 
 /**
-	Utility function to calculate the speed of a cyclist with fixed power
-	but variable slope and mass
+	Utility function to process blocks of matrix rows in parallel
+
+	The rows are split evenly across the hardware threads.
+	Small matrices are processed in the calling thread (thread start > work).
 
-	Annotation1: Speed is reported in KM/H
+	@param nr_rows
+	@param row_function:	Processes the rows [begin, end)
 */
-double velocity_calculation(double mass, double slope, double accuracy = 0.01) {
-	// Check if negative slope
-	if (slope < 0) {
-		return max_speed_cycler;
+void parallel_rows(const int nr_rows, const function<void(int, int)> &row_function) {
+	int nr_threads = min(int(thread::hardware_concurrency()), nr_rows / MIN_ROWS_PER_THREAD);
+
+	if (nr_threads <= 1) {
+		row_function(0, nr_rows);
+		return;
 	}
 
-	// Define forces
-	double rolling_resistance = (COEFFICIENT_ROLLING * mass * GRAVITY * cos(atan(slope)));
-	double gravity = mass * GRAVITY * sin(atan(slope));
-
-	// calculate velocity
-	// Start with accuracy/2 to ensure correct rounding!
-	// 1.9 because we want to ensure that no floating error can mess this up!
-	double velocity = 0 + accuracy/1.99;
-	bool x = true;
-
-	while (x) {
-		double drag = AIR_RESISTANCE_CONSTANT * pow(velocity/KMHTOMS, 2);
-		double current_power = (drag + rolling_resistance + gravity)*velocity/KMHTOMS/ 0.95;
-		if (current_power - POWER < 0) {
-			velocity += accuracy;
-		}
-		else {
-			x = false;
-		}
+	vector<thread> threads;
+	for (int thread_id = 0; thread_id < nr_threads; thread_id++) {
+		int begin = nr_rows * thread_id / nr_threads;
+		int end = nr_rows * (thread_id + 1) / nr_threads;
+		threads.push_back(thread(row_function, begin, end));
 	}
 
-	if (velocity < max_speed_cycler) {
-		// The initial rounding bias must be corrected again
-		return velocity - accuracy/1.99;
+	for (thread &t : threads) {
+		t.join();
 	}
-	else {
-		return max_speed_cycler;
+}
+
+/**
+	Utility function to get the slope dependent resistance (rolling + gravity) per kg of mass
+
+	Annotation: cos(atan(slope)) = 1/sqrt(1+slope^2), sin(atan(slope)) = slope*cos(atan(slope))
+*/
+inline double get_slope_resistance(double slope) {
+	double cos_slope = 1 / sqrt(1 + slope*slope);
+	return GRAVITY * (COEFFICIENT_ROLLING * cos_slope + slope * cos_slope);
+}
+
+/**
+	Utility function to calculate the speed of a cyclist with fixed power
+	but variable slope and mass (for a row of arcs)
+
+	The power balance (drag + rolling + gravity) * v = POWER * efficiency
+	is a depressed cubic in v (m/s):	a*v^3 + b*v - c = 0		(a, b, c > 0 for slope >= 0)
+	It has exactly one real root r <= c/b and the function is convex for v > 0.
+	Newton started right of r therefore converges monotonically.
+
+	Start values:
+		- cold: min(c/b, max speed) is at most a factor of 3 off (from the left of r
+				the first step leads to the right of r) -> NEWTON_STEPS
+		- warm: The root of the next lighter load level is right of r
+				and only a few percent off -> NEWTON_STEPS_WARM
+
+	The loops run step by step over complete rows (no branches, no cbrt)
+	which allows their vectorization.
+
+	Annotation1: Speed is reported in m/s and not capped at the max speed!
+	Annotation2: Only valid for slopes >= 0 (negative slopes are driven at max speed)
+
+	@param mass:				Total mass (vehicle + load)
+	@param slope_resistances:	Resistance per kg of each arc (see get_slope_resistance)
+	@param velocities:			Start values (if warm) and resulting velocities of each arc
+	@param nr_arcs
+	@param warm_start:			Use the given velocities as start values
+*/
+void velocity_calculation(const double mass,
+	const double *slope_resistances,
+	double *velocities,
+	const int nr_arcs,
+	const bool warm_start)
+{
+	const double a = AIR_RESISTANCE_CONSTANT;
+	const double c = POWER * DRIVETRAIN_EFFICIENCY;
+	const double max_velocity = max_speed_cycler / KMHTOMS;
+
+	if (!warm_start) {
+		for (int j = 0; j < nr_arcs; j++) {
+			velocities[j] = min(c / (mass * slope_resistances[j]), max_velocity);
+		}
+	}
+
+	int nr_steps = warm_start ? NEWTON_STEPS_WARM : NEWTON_STEPS;
+	for (int step = 0; step < nr_steps; step++) {
+		for (int j = 0; j < nr_arcs; j++) {
+			double b = mass * slope_resistances[j];
+			double v = velocities[j];
+			velocities[j] = v - (a*v*v*v + b*v - c) / (3 * a*v*v + b);
+		}
 	}
 }
 
@@ -65,28 +123,29 @@ double velocity_calculation(double mass, double slope, double accuracy = 0.01) {
 
 	Ratio is rise over run (elevation / distance)
 */
-vector<vector<double>> get_slope_matrix(const vector<vector<double>> distance_matrix, const vector<vector<double>> elevation_matrix)
+vector<vector<double>> get_slope_matrix(const vector<vector<double>> &distance_matrix, const vector<vector<double>> &elevation_matrix)
 {
 	// initialize control flow
 	const int nr_nodes = distance_matrix.size();
 	vector<vector<double>> slope_matrix(nr_nodes, vector<double>(nr_nodes));
 
-	// compute values and insert them
-	for (int i = 0; i < nr_nodes; i++) {
-		for (int j = 0; j < nr_nodes; j++) {
-			double elevation = elevation_matrix[i][j];
-			double distance = distance_matrix[i][j];
-			// case 1: Distance = 0 | same node
-			if (distance == 0.0) {
-				slope_matrix[i][j] = 0;
-			}
-			// case 2: Distance > 0
-			else {
-				double ground_distance = sqrt(pow(distance*1000,2) - pow(elevation,2));
-				slope_matrix[i][j] = (elevation / ground_distance);
+	// compute values and insert them (rows in parallel, vectorized over j)
+	parallel_rows(nr_nodes, [&](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			const double *distance = distance_matrix[i].data();
+			const double *elevation = elevation_matrix[i].data();
+			double *slope = slope_matrix[i].data();
+
+			for (int j = 0; j < nr_nodes; j++) {
+				double ground_distance = sqrt(distance[j] * 1000 * distance[j] * 1000 - elevation[j] * elevation[j]);
+				double ratio = elevation[j] / ground_distance; // computed for all j (branch free)
+
+				// case 1: Distance = 0 | same node
+				// case 2: Distance > 0
+				slope[j] = (distance[j] == 0.0) ? 0.0 : ratio;
 			}
 		}
-	}
+	});
 	return slope_matrix;
 }
 
@@ -96,15 +155,20 @@ vector<vector<double>> get_slope_matrix(const vector<vector<double>> distance_ma
 	load level x nodes x nodes
 
 	Annotation: Time is reported in hours!
+	Annotation2: The rows are built in parallel straight into the flat (bucket major) cube
+	Annotation3: Compressed: all buckets of a row are built in a buffer of the thread and
+				 load invariant arcs are stored once -> the dense cube never exists
 
 	@param distance_matrix
+	@param compressed:	Build the compressed layout (see time_cube.h)
 */
-vector<vector<vector<double>>> get_time_cube(const vector<vector<double>> distance_matrix,
-	const vector<vector<double>> slope_matrix,
+TimeCube get_time_cube(const vector<vector<double>> &distance_matrix,
+	const vector<vector<double>> &slope_matrix,
 	const double vehicle_weight,
 	const double vehicle_capacity,
 	const double add_pseudo_capacity,
-	double weight_interval_size)
+	double weight_interval_size,
+	const bool compressed)
 {
 	// get number of intervals
 	double max_capacity_considered = (vehicle_capacity + add_pseudo_capacity);
@@ -112,65 +176,101 @@ vector<vector<vector<double>>> get_time_cube(const vector<vector<double>> distan
 	int nr_intervals = int(ceil(max_capacity_considered / weight_interval_size));
 	const int nr_nodes = distance_matrix.size();
 
-	// Build the three dimensional matrix (with 0 as default values)
-	vector<vector<vector<double>>> time_cube(nr_intervals, vector<vector<double>>(nr_nodes, vector<double>(nr_nodes)));
+	// Build the flat three dimensional cube (with 0 as default values)
+	// or the values and runs of each row (compressed)
+	TimeCube time_cube = compressed ? TimeCube() : TimeCube(nr_intervals, nr_nodes);
+	vector<vector<double>> row_values(compressed ? nr_nodes : 0);
+	vector<vector<TimeCube::ArcRun>> row_runs(compressed ? nr_nodes : 0, vector<TimeCube::ArcRun>(nr_nodes));
 
-	// Fill the values
+	// Get the mass for each interval (use min to cut the mass at the max)
+	// Compute the middle of the interval!
+	vector<double> masses(nr_intervals);
 	for (int interval = 0; interval < nr_intervals; interval++) {
-		// get the mass for each interval (use min to cut the mass at the max)
-		// Compute the middle of the interval!
-		//double additional_mass = min(max_capacity_considered, interval*(weight_interval_size)+weight_interval_size/2);
-		double additional_mass = min(max_capacity_considered, interval*(weight_interval_size)+weight_interval_size/2);
-
-		for (int i = 0; i < nr_nodes; i++) {
-			// We cannot start from i and set ij, ji at equal time
-			// Because of the differing slope matrix!
+		masses[interval] = vehicle_weight + min(max_capacity_considered, interval*(weight_interval_size)+weight_interval_size/2);
+	}
+
+	// Fill the values
+	// We cannot start from i and set ij, ji at equal time
+	// Because of the differing slope matrix!
+	parallel_rows(nr_nodes, [&](int begin, int end) {
+		vector<double> slope_resistances(nr_nodes);
+		vector<double> velocities(nr_nodes);
+		vector<double> row_times(compressed ? size_t(nr_intervals)*nr_nodes : 0); // [interval][j]
+
+		for (int i = begin; i < end; i++) {
+			const double *distance = distance_matrix[i].data();
+			const double *slope = slope_matrix[i].data();
+
+			// slope terms are identical for all intervals
 			for (int j = 0; j < nr_nodes; j++) {
-				// get the velocity for the current step
-				double velocity = velocity_calculation(vehicle_weight + additional_mass, slope_matrix[i][j]);
+				slope_resistances[j] = get_slope_resistance(slope[j]);
+			}
 
-				if (i == 0 & j == 7) {
-					cout << "velocity: " << velocity << "additonal mass: " << additional_mass << endl;
-				}
+			// The masses increase with the interval -> warm start from the previous interval
+			for (int interval = 0; interval < nr_intervals; interval++) {
+				velocity_calculation(masses[interval], slope_resistances.data(), velocities.data(), nr_nodes, interval > 0);
 
-				double time = (distance_matrix[i][j] / velocity)*60;
+				double *times = compressed ? row_times.data() + size_t(interval)*nr_nodes : time_cube.row(interval, i);
+				for (int j = 0; j < nr_nodes; j++) {
+					double velocity = min(velocities[j] * KMHTOMS, double(max_speed_cycler));
+					velocity = (slope[j] < 0) ? max_speed_cycler : velocity;
+
+					times[j] = (distance[j] / velocity) * 60;
+				}
+			}
 
-				// set the values
-				time_cube[interval][i][j] = time;
+			if (compressed) {
+				for (int j = 0; j < nr_nodes; j++) {
+					row_runs[i][j] = TimeCube::append_arc(row_values[i], row_times.data() + j, nr_nodes, nr_intervals);
+				}
 			}
 		}
+	});
+
+	if (compressed) {
+		return TimeCube::from_rows(nr_intervals, nr_nodes, row_values, row_runs);
 	}
 	return time_cube;
 }
 
+/**
+Utility function to get the range of the pairwise differences |v[i] - v[j]| (max - min)
+*/
+double get_difference_range(const vector<double> &v) {
+	if (v.empty()) {
+		return 0;
+	}
+	return *max_element(v.begin(), v.end()) - *min_element(v.begin(), v.end());
+}
+
 /*
 Create preprocessed information relevant for VRPTW and VRPLDTT
+
+Only the bounds of the min max normalization of the shaw relatedness are computed,
+the normalized terms are derived on the fly (see ALNSData::get_norm_distance)
+-> no node x node matrices besides the distances.
 */
 void ALNSData::general_preprocessing() {
 	double min_d = std::numeric_limits<double>::max();
 	double max_d = -std::numeric_limits<double>::max();
+	int nr_distance_nodes = this->distance_matrix.empty() ? this->time_cube.get_nr_nodes() : int(this->distance_matrix.size());
 
-	for (unsigned int i = 0; i < this->distance_matrix.size(); i++) {
-		vector<double> &v2 = this->distance_matrix[i];
-
-		for (unsigned int j = 0; j < v2.size(); j++) {
-			if (distance_matrix[i][j] < min_d) {
-				min_d = distance_matrix[i][j];
-			}
-
-			if (distance_matrix[i][j] > max_d) {
-				max_d = distance_matrix[i][j];
-			}
+	for (int i = 0; i < nr_distance_nodes; i++) {
+		for (int j = 0; j < nr_distance_nodes; j++) {
+			double distance = this->get_distance(i, j);
+			min_d = min(min_d, distance);
+			max_d = max(max_d, distance);
 		}
 	}
 
-	this->norm_distance_matrix = tools::normalize_matrix_copy(distance_matrix, min_d, max_d);
-	this->norm_start_window_matrix = tools::get_norm_distance_matrix(this->start_window);
-	this->norm_end_window_matrix = tools::get_norm_distance_matrix(this->end_window);
-	this->norm_demand_matrix = tools::get_norm_distance_matrix(this->demand);
+	this->min_distance = min_d;
+	this->distance_range = max_d - min_d;
+	this->start_window_range = get_difference_range(this->start_window);
+	this->end_window_range = get_difference_range(this->end_window);
+	this->demand_range = get_difference_range(this->demand);
 }
 
-void ALNSData::vrpldtt_preprocessing() {
+void ALNSData::vrpldtt_preprocessing(bool compress_time_cube) {
 	// 1) get slope matrix
 	this->slope_matrix =  get_slope_matrix(this->distance_matrix, this->elevation_matrix);
 
@@ -180,5 +280,60 @@ void ALNSData::vrpldtt_preprocessing() {
 		this->vehicle_weight,
 		this->vehicle_cap,
 		this->add_pseudo_capacity,
-		this->load_bucket_size);
+		this->load_bucket_size,
+		compress_time_cube);
+}
+
+/**
+Compute the granular neighbourhood of each customer
+
+The relatedness of two customers is the travel time of the empty vehicle (bucket 0)
+plus the waiting and lateness if one is served directly after the other
+(earliest start of the first customer). The better of both directions counts.
+
+Insertion operators only evaluate positions adjacent to a candidate and
+the shaw removal only selects from the candidates of the removed customers.
+
+@param nr_candidates:	Number of candidates per customer (<= 0 -> disabled)
+*/
+void ALNSData::set_candidate_lists(int nr_candidates) {
+	this->nr_candidates = max(0, min(nr_candidates, this->nr_customer - 1));
+	this->candidate_lists.clear();
+	this->candidate_matrix.clear();
+
+	if (this->nr_candidates == 0) {
+		return;
+	}
+
+	this->candidate_lists.resize(this->nr_customer);
+	this->candidate_matrix.assign(this->nr_customer, vector<bool>(this->nr_customer, false));
+
+	// direct visit of customer j after customer i (node ids are customer ids + 1)
+	auto get_visit_cost = [this](int i, int j) {
+		double travel_time = this->time_cube(0, i + 1, j + 1);
+		double arrival = this->start_window[i] + this->service_times[i] + travel_time;
+
+		return travel_time
+			+ max(0.0, this->start_window[j] - arrival) // waiting
+			+ max(0.0, arrival - this->end_window[j]); // lateness
+	};
+
+	vector<pair<double, int>> relatedness(this->nr_customer - 1);
+	for (int i = 0; i < this->nr_customer; i++) {
+		int pos = 0;
+		for (int j = 0; j < this->nr_customer; j++) {
+			if (j != i) {
+				relatedness[pos] = pair<double, int>(min(get_visit_cost(i, j), get_visit_cost(j, i)), j);
+				pos++;
+			}
+		}
+
+		partial_sort(relatedness.begin(), relatedness.begin() + this->nr_candidates, relatedness.end());
+
+		this->candidate_lists[i].resize(this->nr_candidates);
+		for (int k = 0; k < this->nr_candidates; k++) {
+			this->candidate_lists[i][k] = relatedness[k].second;
+			this->candidate_matrix[i][relatedness[k].second] = true;
+		}
+	}
 }
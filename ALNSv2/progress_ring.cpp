@@ -0,0 +1,65 @@
+/**
+This file contains the lock free progress ring (see progress_ring.h)
+*/
+#include "progress_ring.h"
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+ProgressRing::ProgressRing(size_t capacity) :
+	enqueue_pos(0),
+	dequeue_pos(0),
+	nr_dropped(0)
+{
+	size_t size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+
+	this->cells.reset(new Cell[size]);
+	this->mask = size - 1;
+
+	for (size_t pos = 0; pos < size; pos++) {
+		this->cells[pos].sequence.store(pos, memory_order_relaxed);
+	}
+}
+
+bool ProgressRing::pop(ProgressRecord &record) {
+	size_t pos = this->dequeue_pos.load(memory_order_relaxed);
+
+	while (true) {
+		Cell &cell = this->cells[pos & this->mask];
+		size_t sequence = cell.sequence.load(memory_order_acquire);
+		intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+
+		if (diff == 0) {
+			if (this->dequeue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+				record = cell.record;
+				// free the cell for the producer of the next round
+				cell.sequence.store(pos + this->mask + 1, memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0) {
+			// empty (or the next record is not published yet)
+			return false;
+		}
+		else {
+			pos = this->dequeue_pos.load(memory_order_relaxed);
+		}
+	}
+}
+
+size_t ProgressRing::drain(vector<ProgressRecord> &records, int64_t max_records) {
+	size_t nr_records = 0;
+	ProgressRecord record;
+
+	while (((max_records < 0) || (int64_t(nr_records) < max_records)) && this->pop(record)) {
+		records.push_back(record);
+		nr_records++;
+	}
+	return nr_records;
+}
@@ -0,0 +1,93 @@
+/**
+Progress log of the search (see ALNS::set_progress_log)
+
+Bounded lock free ring buffer (multi producer / multi consumer, D. Vyukov):
+All islands of a parallel solve write into the ring of the solving object, any thread
+(e.g. python) drains it while the search is running. The search never waits:
+a record that does not fit into a full ring is dropped and counted.
+
+Annotation:
+	Each cell carries a sequence number. A producer claims a cell by a compare and swap of
+	the enqueue position and publishes it by the release store of the sequence -> the consumer
+	only reads completely written records.
+*/
+#pragma once
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+struct ProgressRecord {
+	std::int64_t time_stamp;		// Epoch time in ms (as the visited solution time stamps)
+	std::int64_t iteration;			// Iteration of the island
+	double best_driving_time;		// Incumbent of the island (max double: no feasible solution yet)
+	double current_quality;			// Quality of the current solution
+	double temperature;
+	std::int32_t destroy_id;		// Operators of the iteration (ids of the wheels)
+	std::int32_t repair_id;
+	std::int32_t island_id;			// 0: solving object
+	bool is_improvement;			// false: interval record
+};
+
+class ProgressRing {
+private:
+	struct Cell {
+		std::atomic<std::size_t> sequence;
+		ProgressRecord record;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	std::size_t mask;
+
+	// (separate cache lines of the producers and consumers)
+	char padding_0[64];
+	std::atomic<std::size_t> enqueue_pos;
+	char padding_1[64];
+	std::atomic<std::size_t> dequeue_pos;
+	char padding_2[64];
+	std::atomic<std::int64_t> nr_dropped;
+
+public:
+	// [capacity] is rounded up to the next power of 2
+	explicit ProgressRing(std::size_t capacity);
+
+	std::size_t capacity() const { return this->mask + 1; }
+	std::int64_t get_nr_dropped() const { return this->nr_dropped.load(std::memory_order_relaxed); }
+
+	/**
+	Append a record (any thread, wait free if not contended)
+	@return:	false if the ring is full (the record is dropped)
+	*/
+	inline bool push(const ProgressRecord &record) {
+		std::size_t pos = this->enqueue_pos.load(std::memory_order_relaxed);
+
+		while (true) {
+			Cell &cell = this->cells[pos & this->mask];
+			std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			std::intptr_t diff = std::intptr_t(sequence) - std::intptr_t(pos);
+
+			if (diff == 0) {
+				if (this->enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+					cell.record = record;
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0) {
+				// the oldest record has not been drained yet
+				this->nr_dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else {
+				pos = this->enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	// Take the oldest record (false: empty)
+	bool pop(ProgressRecord &record);
+
+	// Append up to [max_records] records (negative: all) in write order, returns the number of records
+	std::size_t drain(std::vector<ProgressRecord> &records, std::int64_t max_records = -1);
+};
@@ -1,32 +1,38 @@
 #include "tools.h"
 #include <random>
+#include <math.h>
 
 using namespace std;
 
-
-int tools::rand_number(int max, int min, bool fixed) {
-	/*
-	std::random_device rd; // obtain a random number from hardwar
-	default_random_engine eng{ rd() };
-
-	// We can rewrite the random engine if no fixed seed is wished
-	if (!fixed) {
-		std::mt19937 eng(rd()); // seed the generator
+/**
+Reset the KISS state based on a seed
+The default state of Marsaglia is used for seed 0.
+*/
+void tools::RandomGenerator::seed(uint32_t seed) {
+	this->z = 362436069u ^ seed;
+	this->w = 521288629u + seed;
+	this->jsr = 123456789u ^ (seed << 7);
+	this->jcong = 380116160u + seed;
+
+	// 0 is a fixed point of MWC and SHR3
+	if (this->z == 0) {
+		this->z = 362436069u;
+	}
+	if (this->w == 0) {
+		this->w = 521288629u;
+	}
+	if (this->jsr == 0) {
+		this->jsr = 123456789u;
 	}
-
-	std::uniform_int_distribution<> distr(min, max); // define the range
-
-	return distr(eng);*/
-
-	return int(round(UNI*(max - min) + min));
 }
 
-int tools::rand_number_normal(double mean, double std) {
-	std::random_device rd{};
-	std::mt19937 gen{ rd() };
+int tools::RandomGenerator::rand_number(int max, int min) {
+	return int(round(this->uniform()*(max - min) + min));
+}
 
+int tools::RandomGenerator::rand_number_normal(double mean, double std) {
 	// values near the mean are the most likely
 	// standard deviation affects the dispersion of generated values from the mean
 	std::normal_distribution<> d{ mean, std };
-	return int(std::round(d(gen)));
-}
\ No newline at end of file
+	return int(std::round(d(*this)));
+}
@@ -1,44 +1,85 @@
 #include "roulette_wheel.h"
 #include "tools.h"
 #include <vector>
+#include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 
 /**
 	Utility function to return a random functor based on their weights
-	Idea: Sum all weights and generate a real number with max sum(weights)
+	Idea: Alias method (Walker / Vose). The table is rebuilt whenever the weights change
+	(update_weights), which happens only every [memory_length] iterations.
 
-	Iterate over the sum of weights and select the functor that is just below that
+	A single uniform number selects a column and decides between the column
+	and its alias -> O(1) independent of the number of functors.
+*/
+int RouletteWheel::get_random_functor_id(tools::RandomGenerator &random_generator) {
+	if (this->nr_functors == 0) {
+		throw std::runtime_error("Unexpected error! No functor selected.");
+	}
+
+	double rnd = random_generator.uniform()*this->nr_functors;
+	int column = std::min(int(rnd), this->nr_functors - 1);
+
+	int functor_id = (rnd - column < this->alias_probabilities[column]) ? column : this->alias_ids[column];
 
-	Binary search could also be used but it worse in a setting with constant
-	weight change!
+	this->last_functor_id = functor_id;
+	this->nr_selections[functor_id]++;
+	return functor_id;
+}
+
+/**
+	Build the alias table of the current weights (Vose)
 
-	Funfacts:
-		Worst case complexity is O(2n)
-		Medium complexity is O(1.5n)
+	Each column holds the probability to keep the column (scaled weight)
+	and the functor that fills up the rest of the column (alias).
 */
-int RouletteWheel::get_random_functor_id() {
-	// 1) Get sum of weights! (this changes often!)
-	// Only time O(n_operators) ez.
+void RouletteWheel::build_alias_table() {
+	this->alias_probabilities.assign(this->nr_functors, 1.0);
+	this->alias_ids.resize(this->nr_functors);
+
 	double sum_of_weight = 0;
 	for (double weight : this->weights) {
 		sum_of_weight += weight;
 	}
-	double rnd = UNI*sum_of_weight;
 
-	// 2) Get random functor based on weights
-	double current_weight = 0;
+	// scaled weights: mean 1 (all weights 0 -> equal probabilities)
+	vector<double> scaled(this->nr_functors, 1.0);
+	vector<int> small_ids;
+	vector<int> large_ids;
+
 	for (int functor_id = 0; functor_id < this->nr_functors; functor_id++) {
-		current_weight += weights[functor_id];
+		if (sum_of_weight > 0) {
+			scaled[functor_id] = this->weights[functor_id] * this->nr_functors / sum_of_weight;
+		}
+		this->alias_ids[functor_id] = functor_id;
+
+		if (scaled[functor_id] < 1) {
+			small_ids.push_back(functor_id);
+		}
+		else {
+			large_ids.push_back(functor_id);
+		}
+	}
+
+	// fill the small columns with the large ones
+	while (!small_ids.empty() && !large_ids.empty()) {
+		int small_id = small_ids.back();
+		int large_id = large_ids.back();
+		small_ids.pop_back();
+
+		this->alias_probabilities[small_id] = scaled[small_id];
+		this->alias_ids[small_id] = large_id;
 
-		// check if selected value is below current threshold -> return
-		if (rnd <= current_weight) {
-			this->last_functor_id = functor_id;
-			return functor_id;
+		scaled[large_id] = (scaled[large_id] + scaled[small_id]) - 1;
+		if (scaled[large_id] < 1) {
+			large_ids.pop_back();
+			small_ids.push_back(large_id);
 		}
 	}
 
-	throw std::exception("Unexpected error! No functor selected.");
+	// remaining columns are full (numerical rest) -> probability stays 1
 }
 
 /**
@@ -83,24 +124,35 @@ void RouletteWheel::update_weights() {
 		this->scores[functor_id] = 0;
 		this->nr_uses[functor_id] = 0;
 	}
+
+	this->build_alias_table();
 }
 
 /**
-	Utility function to get a random functor
-	For more documentation see the [get_random_functor_id]
+Add the execution time of the last selected functor to its statistics
 */
-function<vector<int>()>& DestroyRouletteWheel::get_random_operator() {
-	int functor_id = this->get_random_functor_id();
-	return this->destroy_functors[functor_id];
+void RouletteWheel::log_execution_time(double execution_time_ms) {
+	this->selection_times[this->last_functor_id] += execution_time_ms;
 }
 
 /**
-	Utility function to get a random functor
-	For more documentation see the [get_random_functor_id]
+Replace the weights of all functors (at least the min weight) and rebuild the alias table
+The scores of the current memory interval are kept.
 */
-function<void(vector<int>)>& InsertionRouletteWheel::get_random_operator() {
-	int functor_id = this->get_random_functor_id();
-	return this->repair_functors[functor_id];
-}
+void RouletteWheel::set_weights(const vector<double> &new_weights) {
+	if (int(new_weights.size()) != this->nr_functors) {
+		throw invalid_argument("The number of weights must match the number of operators");
+	}
 
+	for (int functor_id = 0; functor_id < this->nr_functors; functor_id++) {
+		this->weights[functor_id] = max(new_weights[functor_id], this->min_weight);
+	}
+	this->build_alias_table();
+}
 
+void RouletteWheel::merge_statistics(const RouletteWheel &other) {
+	for (int functor_id = 0; functor_id < this->nr_functors; functor_id++) {
+		this->nr_selections[functor_id] += other.nr_selections[functor_id];
+		this->selection_times[functor_id] += other.selection_times[functor_id];
+	}
+}
@@ -1,7 +1,7 @@
 #pragma once
 #include <vector>
 #include <queue>
-#include <functional>
+#include "tools.h"
 
 class RouletteWheel {
 public:
@@ -17,6 +17,14 @@ public:
 	std::vector<double> scores; // size of functors
 	std::vector<int> nr_uses; // size of functors
 
+	// Alias table of the current weights (rebuilt with the weights -> O(1) selection)
+	std::vector<double> alias_probabilities; // size of functors
+	std::vector<int> alias_ids; // size of functors
+
+	// Statistics over the whole search (not reset by update_weights)
+	std::vector<int> nr_selections; // size of functors
+	std::vector<double> selection_times; // size of functors, summed execution time [ms]
+
 	// initialize
 	RouletteWheel() {};
 
@@ -30,45 +38,44 @@ public:
 		this->weights = std::vector<double>(nr_functors, (1.0/nr_functors));
 		this->scores = std::vector<double>(nr_functors, 0);
 		this->nr_uses = std::vector<int>(nr_functors, 0);
+		this->nr_selections = std::vector<int>(nr_functors, 0);
+		this->selection_times = std::vector<double>(nr_functors, 0);
+		this->build_alias_table();
 	};
 
 	// match strings to functor objects (simpler)
-	int get_random_functor_id();
+	int get_random_functor_id(tools::RandomGenerator &random_generator);
 	void update_stats(double new_score);
 	void update_weights();
-};
 
+	// Add the execution time of the last selected functor (statistics only)
+	void log_execution_time(double execution_time_ms);
+
+	// Add the statistics of another wheel with the same functors (island model)
+	void merge_statistics(const RouletteWheel &other);
+
+	// Replace the weights (e.g. learned by a previous search, see ALNS::set_search_memory)
+	void set_weights(const std::vector<double> &new_weights);
 
-class DestroyRouletteWheel : public RouletteWheel {
 private:
-	std::vector<std::function<std::vector<int>()>> destroy_functors;
+	void build_alias_table();
+};
+
 
+// Wheels of the destroy / repair operators (ids of the OperatorRegistry)
+class DestroyRouletteWheel : public RouletteWheel {
 public:
 	DestroyRouletteWheel() {};
 
-	DestroyRouletteWheel(std::vector<std::function<std::vector<int>()>> destroy_functors, double wheel_par, int memory_length, double min_weight) : 
-		RouletteWheel(destroy_functors.size(), wheel_par, memory_length, min_weight)
-	{
-		this->destroy_functors = destroy_functors;
-	}
-
-	std::function<std::vector<int>()>& get_random_operator();
+	DestroyRouletteWheel(int nr_functors, double wheel_par, int memory_length, double min_weight) :
+		RouletteWheel(nr_functors, wheel_par, memory_length, min_weight) {}
 };
 
 
 class InsertionRouletteWheel : public RouletteWheel {
-private:
-	std::vector<std::function<void(std::vector<int>)>> repair_functors;
-
 public:
 	InsertionRouletteWheel() {};
 
-	InsertionRouletteWheel(std::vector<std::function<void(std::vector<int>)>> repair_functors, double wheel_par, int memory_length, double min_weight)
-		: RouletteWheel(repair_functors.size(), wheel_par, memory_length, min_weight) 
-	{
-		this->repair_functors = repair_functors;
-	}
-
-	std::function<void(std::vector<int>)>& get_random_operator();
+	InsertionRouletteWheel(int nr_functors, double wheel_par, int memory_length, double min_weight)
+		: RouletteWheel(nr_functors, wheel_par, memory_length, min_weight) {}
 };
-
@@ -0,0 +1,28 @@
+/**
+This file contains the search instrumentation (see search_stats.h)
+*/
+#include "search_stats.h"
+#include <vector>
+
+using namespace std;
+
+void SearchStats::merge(const SearchStats &other) {
+	for (unsigned int id = 0; id < this->destroy_calls.size(); id++) {
+		this->destroy_calls[id] += other.destroy_calls[id];
+		this->destroy_times_ns[id] += other.destroy_times_ns[id];
+	}
+	for (unsigned int id = 0; id < this->insertion_calls.size(); id++) {
+		this->insertion_calls[id] += other.insertion_calls[id];
+		this->insertion_times_ns[id] += other.insertion_times_ns[id];
+	}
+
+	this->nr_iterations += other.nr_iterations;
+	this->iteration_time_ns += other.iteration_time_ns;
+	this->historic_update_time_ns += other.historic_update_time_ns;
+	this->visited_lookup_time_ns += other.visited_lookup_time_ns;
+	this->solution_copy_time_ns += other.solution_copy_time_ns;
+	this->migration_time_ns += other.migration_time_ns;
+
+	this->nr_evaluated_changes += other.nr_evaluated_changes;
+	this->nr_rejected_changes += other.nr_rejected_changes;
+}
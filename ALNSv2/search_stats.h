@@ -0,0 +1,51 @@
+/**
+Instrumentation of the search (where does the solve budget go?)
+
+All times are measured with the steady clock in nanoseconds and summed over the
+whole search (all time slices of solve_for and all islands of a parallel solve).
+
+Annotation:
+	The operator vectors are in the order of the destroy / repair operator names.
+	Infeasible changes used to throw an exception (see Solution::try_evaluate_change).
+*/
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+typedef std::chrono::steady_clock StatsClock;
+
+// Elapsed nanoseconds since [start]
+inline std::int64_t get_elapsed_ns(const StatsClock::time_point &start) {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(StatsClock::now() - start).count();
+}
+
+struct SearchStats {
+	// operator based
+	std::vector<std::int64_t> destroy_calls;
+	std::vector<std::int64_t> destroy_times_ns;
+	std::vector<std::int64_t> insertion_calls;
+	std::vector<std::int64_t> insertion_times_ns;
+
+	// iteration steps
+	std::int64_t nr_iterations = 0;
+	std::int64_t iteration_time_ns = 0;			// complete iterations
+	std::int64_t historic_update_time_ns = 0;	// update_historic_matrices
+	std::int64_t visited_lookup_time_ns = 0;		// visited solution lookup and insert
+	std::int64_t solution_copy_time_ns = 0;		// journal commits / rollbacks and best solution copies
+	std::int64_t migration_time_ns = 0;			// exchange with the other islands (parallel solve)
+
+	// evaluation counters of the running solution
+	std::int64_t nr_evaluated_changes = 0;		// evaluate_change / try_evaluate_change calls
+	std::int64_t nr_rejected_changes = 0;		// max capa infeasibility exceeded
+
+	SearchStats() {};
+	SearchStats(int nr_destroy_operators, int nr_insertion_operators) :
+		destroy_calls(nr_destroy_operators, 0),
+		destroy_times_ns(nr_destroy_operators, 0),
+		insertion_calls(nr_insertion_operators, 0),
+		insertion_times_ns(nr_insertion_operators, 0) {};
+
+	// Add the stats of another search with the same operators (island model)
+	void merge(const SearchStats &other);
+};
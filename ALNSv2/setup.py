@@ -11,22 +11,44 @@ import os, sys
 from distutils.core import setup, Extension
 from distutils import sysconfig
 
-cpp_args = ['-std=c++11', '-stdlib=libc++', '-mmacosx-version-min=10.7']
+# -fno-math-errno / -fno-trapping-math: allow the vectorization of the preprocessing (sqrt, division)
+# (MSVC: default flags of distutils, see CMakeLists.txt for the optimized builds)
+if sys.platform == 'win32':
+    cpp_args = []
+    link_args = []
+elif sys.platform == 'darwin':
+    cpp_args = ['-std=c++11', '-stdlib=libc++', '-mmacosx-version-min=10.7', '-fno-math-errno', '-fno-trapping-math']
+    link_args = []
+else:
+    cpp_args = ['-std=c++11', '-fno-math-errno', '-fno-trapping-math', '-pthread']
+    link_args = ['-pthread']
 
 sfc_module = Extension(
     'ALNSv2', sources = ['module.cpp', 
                          'alns.cpp', 
                          'evaluate.cpp', 
+                         'historic_matrices.cpp',
+                         'indexed_heap.cpp',
                          'initialization.cpp',
                          'operator.cpp',
+                         'operator_registry.cpp',
+                         'construction.cpp',
+                         'progress_ring.cpp',
+                         'batch_solve.cpp',
                          'preprocessing.cpp',
                          'rand_tools.cpp',
                          'vector_tools.cpp',
                          'roulette_wheel.cpp',
-                         'solution.cpp'],
+                         'solution.cpp',
+                         'search_stats.cpp',
+                         'time_cube.cpp',
+                         'data_file.cpp',
+                         'mapped_file.cpp',
+                         'visited_set.cpp'],
     include_dirs=['pybind11/include'],
     language='c++',
     extra_compile_args = cpp_args,
+    extra_link_args = link_args,
     )
 
 setup(
@@ -10,6 +10,8 @@ The efficiency of these evaluation functions is therefore of secundary importanc
 #include "solution.h"
 #include "tools.h"
 #include <vector>
+#include <limits>
+#include <algorithm>
 #include <math.h>
 
 using namespace std;
@@ -71,6 +73,7 @@ Solution::Solution(
 	this->is_feasible = is_feasible;
 	this->start_times = start_times;
 	this->route_driving_times = route_driving_times;
+	this->set_fingerprints();
 };
 
 /**
@@ -84,12 +87,20 @@ Solution& Solution::operator=(const Solution &obj) {
 		// If not identical (reference is equal)
 		this->solution_representation = obj.solution_representation;
 		this->route_chromosome = obj.route_chromosome;
+		this->route_positions = obj.route_positions;
 
 		this->loads = obj.loads;
 		this->load_levels = obj.load_levels;
 		this->arrival_times = obj.arrival_times;
 		this->departure_times = obj.departure_times;
 
+		this->prefix_driving_times = obj.prefix_driving_times;
+		this->suffix_frame_errors = obj.suffix_frame_errors;
+		this->time_slacks = obj.time_slacks;
+
+		this->fingerprint = obj.fingerprint;
+		this->route_fingerprints = obj.route_fingerprints;
+
 		this->driving_time = obj.driving_time;
 		this->capa_error = obj.capa_error;
 		this->frame_error = obj.frame_error;
@@ -101,16 +112,123 @@ Solution& Solution::operator=(const Solution &obj) {
 		this->route_capa_errors = obj.route_capa_errors;
 		this->route_frame_errors = obj.route_frame_errors;
 		this->route_qualities = obj.route_qualities;
+
+		// Both objects are identical -> nothing to track anymore
+		this->clear_journal();
 	}
 	return *this;
 }
 
+/**
+Journal functions
+
+Every change of a route is evaluated with either evaluate_change (one route)
+or evaluate_solution (all routes). Both mark the routes as dirty.
+The customer based info of a customer can only change if the customer is part
+of a dirty route (before or after the change).
+
+This allows to synchronize two solutions that were identical before
+the last operators by copying only the dirty routes and their customers.
+*/
+void Solution::mark_dirty(const int route_id) {
+	if (this->route_is_dirty.size() != this->solution_representation.size()) {
+		this->route_is_dirty.assign(this->solution_representation.size(), false);
+		this->dirty_routes.clear();
+	}
+
+	if (!this->route_is_dirty[route_id]) {
+		this->route_is_dirty[route_id] = true;
+		this->dirty_routes.push_back(route_id);
+	}
+}
+
+void Solution::mark_all_dirty() {
+	for (unsigned int route_id = 0; route_id < this->solution_representation.size(); route_id++) {
+		this->mark_dirty(route_id);
+	}
+}
+
+void Solution::clear_journal() {
+	for (int route_id : this->dirty_routes) {
+		this->route_is_dirty[route_id] = false;
+	}
+	this->dirty_routes.clear();
+}
+
+/**
+Copy the given routes, their customer based info and all KPIs of obj
+
+Annotation:
+	Both solutions must be identical in all other routes!
+	The customers of the routes of both objects are copied (moved customers)
+*/
+void Solution::copy_routes(const Solution &obj, const std::vector<int> &route_ids) {
+	// 1) Route based info
+	for (int route_id : route_ids) {
+		this->solution_representation[route_id] = obj.solution_representation[route_id];
+		this->route_fingerprints[route_id] = obj.route_fingerprints[route_id];
+
+		this->start_times[route_id] = obj.start_times[route_id];
+		this->route_driving_times[route_id] = obj.route_driving_times[route_id];
+		this->route_capa_errors[route_id] = obj.route_capa_errors[route_id];
+		this->route_frame_errors[route_id] = obj.route_frame_errors[route_id];
+		this->route_qualities[route_id] = obj.route_qualities[route_id];
+	}
+
+	// 2) Customer based info
+	for (int route_id : route_ids) {
+		for (int customer_id : obj.solution_representation[route_id]) {
+			this->route_chromosome[customer_id] = obj.route_chromosome[customer_id];
+			this->route_positions[customer_id] = obj.route_positions[customer_id];
+
+			this->loads[customer_id] = obj.loads[customer_id];
+			this->load_levels[customer_id] = obj.load_levels[customer_id];
+			this->arrival_times[customer_id] = obj.arrival_times[customer_id];
+			this->departure_times[customer_id] = obj.departure_times[customer_id];
+
+			this->prefix_driving_times[customer_id] = obj.prefix_driving_times[customer_id];
+			this->suffix_frame_errors[customer_id] = obj.suffix_frame_errors[customer_id];
+			this->time_slacks[customer_id] = obj.time_slacks[customer_id];
+		}
+	}
+
+	// 3) KPIs
+	this->fingerprint = obj.fingerprint;
+	this->driving_time = obj.driving_time;
+	this->capa_error = obj.capa_error;
+	this->frame_error = obj.frame_error;
+	this->is_feasible = obj.is_feasible;
+	this->solution_quality = obj.solution_quality;
+}
+
+/**
+Accept the changes: Copy all dirty routes of this solution to obj
+
+@param obj:		Solution that was identical before the changes of the journal
+*/
+void Solution::commit_journal(Solution &obj) {
+	obj.copy_routes(*this, this->dirty_routes);
+	this->clear_journal();
+}
+
+/**
+Reject the changes: Restore all dirty routes of this solution from obj
+
+@param obj:		Solution that was identical before the changes of the journal
+*/
+void Solution::rollback_journal(const Solution &obj) {
+	this->copy_routes(obj, this->dirty_routes);
+	this->clear_journal();
+}
+
 /**
 Base function to reevaluate the solution object from scratch
 Is used in heavy destroy operators or initialization
 */
 void Solution::evaluate_solution(double capa_error_weight, double frame_error_weight) {
+	this->mark_all_dirty();
 	this->set_chromosomes();
+	this->set_fingerprints();
 	this->set_load_levels();
 	this->set_solution_time();
 	this->set_capa_error();
@@ -130,6 +248,7 @@ void Solution::set_chromosomes() {
 	ALNSData &data = this->data_obj.get();
 
 	vector<int> route_chromosome(data.nr_customer);
+	vector<int> route_positions(data.nr_customer, -1);
 
 	int route_id = 0;
 	for (vector<int> &route : this->solution_representation) {
@@ -138,9 +257,34 @@ void Solution::set_chromosomes() {
 			route,
 			route_id);
 
+		route_evaluate::update_route_positions(route_positions, route);
+
 		route_id++;
 	}
 	this->route_chromosome = route_chromosome;
+	this->route_positions = route_positions;
+}
+
+/**
+Set the route fingerprints and the solution fingerprint from scratch
+*/
+void Solution::set_fingerprints() {
+	this->fingerprint = Fingerprint();
+	this->route_fingerprints.resize(this->solution_representation.size());
+
+	for (unsigned int route_id = 0; route_id < this->solution_representation.size(); route_id++) {
+		this->route_fingerprints[route_id] = fingerprint::get_route_fingerprint(this->solution_representation[route_id]);
+		this->fingerprint ^= this->route_fingerprints[route_id];
+	}
+}
+
+/**
+Replace the fingerprint of a changed route (the other routes are untouched)
+*/
+void Solution::update_fingerprint(const int route_id) {
+	this->fingerprint ^= this->route_fingerprints[route_id];
+	this->route_fingerprints[route_id] = fingerprint::get_route_fingerprint(this->solution_representation[route_id]);
+	this->fingerprint ^= this->route_fingerprints[route_id];
 }
 
 
@@ -184,6 +328,9 @@ void Solution::set_solution_time() {
 	vector<double> route_driving_times(solution_representation.size(), 0);
 	vector<double> arr_times(data.nr_customer);
 	vector<double> dep_times(data.nr_customer);
+	vector<double> prefix_driving_times(data.nr_customer);
+	vector<double> suffix_frame_errors(data.nr_customer);
+	vector<double> time_slacks(data.nr_customer);
 
 	// we must consider all routes
 	int route_id = 0;
@@ -208,6 +355,18 @@ void Solution::set_solution_time() {
 			data.time_cube,
 			data.service_times);
 
+		route_evaluate::update_route_segments(
+			prefix_driving_times,
+			suffix_frame_errors,
+			time_slacks,
+			start_time,
+			route,
+			this->load_levels,
+			arr_times,
+			dep_times,
+			data.end_window,
+			data.time_cube);
+
 		total_time += route_driving_times[route_id];
 		route_id++;
 	}
@@ -217,6 +376,9 @@ void Solution::set_solution_time() {
 	this->route_driving_times = route_driving_times;
 	this->arrival_times = arr_times;
 	this->departure_times = dep_times;
+	this->prefix_driving_times = prefix_driving_times;
+	this->suffix_frame_errors = suffix_frame_errors;
+	this->time_slacks = time_slacks;
 }
 
 /**
@@ -289,7 +451,7 @@ void Solution::set_quality(const double capa_error_weight, const double frame_er
 	ALNSData &data = this->data_obj.get();
 
 	double solution_quality = 0;
-	vector<double> route_qualities(data.nr_vehicles);
+	this->route_qualities.resize(data.nr_vehicles); // (in place, called after each batched removal)
 
 	for (int route_id = 0; route_id < data.nr_vehicles; route_id++) {
 
@@ -300,11 +462,10 @@ void Solution::set_quality(const double capa_error_weight, const double frame_er
 			frame_error_weight);
 		
 		solution_quality += route_quality;
-		route_qualities[route_id] = route_quality;
+		this->route_qualities[route_id] = route_quality;
 	}
 
 	this->solution_quality = solution_quality;
-	this->route_qualities = route_qualities;
 }
 
 /**
@@ -335,9 +496,32 @@ void Solution::evaluate_change(
 	const int ins_pos,
 	const double capa_error_weight,
 	const double frame_error_weight)
+{
+	if (!this->try_evaluate_change(route_id, ins_pos, capa_error_weight, frame_error_weight)) {
+		throw InfeasibilityException();
+	}
+}
+
+/**
+Non throwing version of evaluate_change (for the hot insertion loops)
+
+@return:	false if the max capa error is exceeded after insertion
+			(the object is in the same state as after the exception of evaluate_change)
+*/
+bool Solution::try_evaluate_change(
+	const int route_id,
+	const int ins_pos,
+	const double capa_error_weight,
+	const double frame_error_weight)
 {
 	ALNSData &data = this->data_obj.get();
 	vector<int> &route = this->solution_representation[route_id];
+	this->mark_dirty(route_id);
+	this->update_fingerprint(route_id);
+	this->nr_evaluated_changes++;
+
+	// (ins_pos is only the last changed position, e.g. of an inserted chain -> complete route)
+	route_evaluate::update_route_positions(this->route_positions, route);
 
 	// 1) Check if we are within the computational limits! (load levels)
 	// Update load levels and compute if its still within its limits
@@ -354,8 +538,11 @@ void Solution::evaluate_change(
 	this->capa_error += route_capa_error;
 
 	// Check if insertion exceeds max capa infeasibility
+	// (keep the route capa error -> the total stays consistent with the reevaluation after the reset)
 	if (route_capa_error >= data.add_pseudo_capacity) {
-		throw InfeasibilityException();
+		this->route_capa_errors[route_id] = route_capa_error;
+		this->nr_rejected_changes++;
+		return false;
 	}
 
 	// 2) Update all necessary travel time KPIs
@@ -382,6 +569,18 @@ void Solution::evaluate_change(
 		data.time_cube,
 		data.service_times);
 
+	route_evaluate::update_route_segments(
+		this->prefix_driving_times,
+		this->suffix_frame_errors,
+		this->time_slacks,
+		start_time,
+		route,
+		this->load_levels,
+		this->arrival_times,
+		this->departure_times,
+		data.end_window,
+		data.time_cube);
+
 	double route_frame_error = route_evaluate::get_frame_error(route,
 		data.end_window,
 		this->arrival_times);
@@ -399,31 +598,563 @@ void Solution::evaluate_change(
 	this->route_qualities[route_id] = route_quality;
 
 	this->set_is_feasible();
+	return true;
 }
 
+/**
+Remove customers from their routes and reevaluate only the changed routes
 
-double Solution::get_diversity(std::vector<std::vector<int>> &node_pair_useage_matrix, int iteration) {
-	ALNSData &data = this->data_obj;
+	1) Locate the customers with the position index (no search in the routes)
+	2) Compact each changed route once (independent of the number of removed customers)
+	3) Reevaluate the changed routes in place
+	4) Sum the KPIs over all routes
 
-	int new_iter = iteration + 1;
-	int diversity_norm = data.nr_customer;
-	double diversity = 0;
+The result is identical to a removal followed by evaluate_solution, but
+the untouched routes are not reevaluated and no vectors are reallocated.
 
-	for (vector<int> &route : this->solution_representation) {
-		// each none empty route adds one more edge
-		if (route.size() > 0) {
-			diversity_norm++;
-
-			int prev_node_id = 0;
-			for (int customer_id : route) {
-				diversity += (1 - (node_pair_useage_matrix[prev_node_id][customer_id + 1] / new_iter));
-				prev_node_id = customer_id + 1;
-			}
-
-			// back to depot
-			diversity += (1 - (node_pair_useage_matrix[prev_node_id][0] / new_iter));
+Annotation:
+	The customer based info of the removed customers is not reset
+	(their route position is -1 until they are inserted again).
+
+@param customer_ids:			Customers to remove (each must be part of a route)
+@param capa_error_weight:		Weight for the capacity error (for quality calculation)
+@param frame_error_weight:		Weight for the frame error (for quality calculation)
+*/
+void Solution::remove_customers(
+	const vector<int> &customer_ids,
+	const double capa_error_weight,
+	const double frame_error_weight)
+{
+	// 1) Group the customers by route (flag them as removed)
+	this->removal_route_ids.clear();
+	for (int customer_id : customer_ids) {
+		this->removal_route_ids.push_back(this->route_chromosome[customer_id]);
+		this->route_positions[customer_id] = -1;
+	}
+	sort(this->removal_route_ids.begin(), this->removal_route_ids.end());
+	this->removal_route_ids.erase(unique(this->removal_route_ids.begin(), this->removal_route_ids.end()), this->removal_route_ids.end());
+
+	// 2) + 3) Compact and reevaluate the changed routes
+	for (int route_id : this->removal_route_ids) {
+		vector<int> &route = this->solution_representation[route_id];
+		route.erase(remove_if(route.begin(), route.end(), [this](int customer_id) {return this->route_positions[customer_id] < 0; }), route.end());
+
+		this->evaluate_route(route_id);
+	}
+
+	// 4) KPIs (same summation order as evaluate_solution)
+	double driving_time = 0.0;
+	double capa_error = 0;
+	double frame_error = 0;
+	for (unsigned int route_id = 0; route_id < this->solution_representation.size(); route_id++) {
+		driving_time += this->route_driving_times[route_id];
+		capa_error += this->route_capa_errors[route_id];
+		frame_error += this->route_frame_errors[route_id];
+	}
+	this->driving_time = driving_time;
+	this->capa_error = capa_error;
+	this->frame_error = frame_error;
+
+	this->set_quality(capa_error_weight, frame_error_weight);
+	this->set_is_feasible();
+}
+
+/**
+Reevaluate all customer and route based info of a route from scratch (in place)
+The solution KPIs are not updated (see remove_customers)
+*/
+void Solution::evaluate_route(const int route_id) {
+	ALNSData &data = this->data_obj.get();
+	vector<int> &route = this->solution_representation[route_id];
+	this->mark_dirty(route_id);
+	this->update_fingerprint(route_id);
+
+	route_evaluate::update_route_positions(this->route_positions, route);
+
+	route_evaluate::update_load_levels(this->loads,
+		this->load_levels,
+		route,
+		route.size() - 1,
+		data.demand,
+		data.load_bucket_size);
+
+	double start_time = route_evaluate::get_starting_time(
+		route,
+		this->load_levels,
+		data.start_window,
+		data.time_cube);
+
+	this->start_times[route_id] = start_time;
+
+	route_evaluate::update_visit_times(
+		this->route_driving_times[route_id],
+		this->arrival_times,
+		this->departure_times,
+		start_time,
+		route,
+		this->load_levels,
+		data.start_window,
+		data.time_cube,
+		data.service_times);
+
+	route_evaluate::update_route_segments(
+		this->prefix_driving_times,
+		this->suffix_frame_errors,
+		this->time_slacks,
+		start_time,
+		route,
+		this->load_levels,
+		this->arrival_times,
+		this->departure_times,
+		data.end_window,
+		data.time_cube);
+
+	this->route_capa_errors[route_id] = route_evaluate::get_capa_error(route, data.vehicle_cap, this->loads);
+	this->route_frame_errors[route_id] = route_evaluate::get_frame_error(route,
+		data.end_window,
+		this->arrival_times);
+}
+
+/**
+Check if an insertion exceeds the max capa error without touching the route
+The first customer carries the load of the complete route.
+
+@param route_id					Route ID of the insertion
+@param additional_demand		Demand of all inserted customers
+*/
+bool Solution::exceeds_max_capa_error(const int route_id, const double additional_demand) const {
+	const ALNSData &data = this->data_obj.get();
+	const vector<int> &route = this->solution_representation[route_id];
+
+	double route_load = additional_demand;
+	if (route.size() > 0) {
+		route_load += this->loads[route[0]];
+	}
+	return max(0.0, route_load - data.vehicle_cap) >= data.add_pseudo_capacity;
+}
+
+
+/**
+Compute the shifted prefix of an insertion of [customer_id] into [route_id].
+
+All customers of the route carry the additional demand if they are visited
+before the new customer. We therefore evaluate the complete route once with
+the shifted loads. Each insertion position then only uses the part in front of it.
+
+@param customer_id				Customer id to be inserted
+@param route_id					Route ID where the customer id should be inserted
+@param prefix					Prefix object that is (re)filled
+
+@return:						false if the max capa error is exceeded after insertion
+								(the capacity error is identical for all positions, prefix not filled)
+*/
+bool Solution::set_insertion_prefix(
+	const int customer_id,
+	const int route_id,
+	InsertionPrefix &prefix) const
+{
+	ALNSData &data = this->data_obj.get();
+	const vector<int> &route = this->solution_representation[route_id];
+	const double demand = data.demand[customer_id];
+
+	// 1) Capacity check (the first customer carries the highest load)
+	double route_load = demand;
+	if (route.size() > 0) {
+		route_load += this->loads[route[0]];
+	}
+
+	prefix.customer_id = customer_id;
+	prefix.route_id = route_id;
+	prefix.capa_error = max(0.0, route_load - data.vehicle_cap);
+
+	if (prefix.capa_error >= data.add_pseudo_capacity) {
+		return false;
+	}
+
+	// 2) Visit times with shifted load levels
+	prefix.departure_times.resize(route.size());
+	prefix.driving_times.resize(route.size());
+	prefix.frame_errors.resize(route.size());
+
+	double current_time = 0;
+	double driving_time = 0;
+	double frame_error = 0;
+	int prev_node_id = 0;
+
+	for (unsigned int route_pos = 0; route_pos < route.size(); route_pos++) {
+		int route_customer_id = route[route_pos];
+		int load_level = route_evaluate::get_load_bucket(this->loads[route_customer_id] + demand, data.load_bucket_size);
+		double ctoctime = data.time_cube(load_level, prev_node_id, route_customer_id + 1);
+
+		// route start (see route_evaluate::get_starting_time)
+		if (route_pos == 0) {
+			current_time = max(0.0, data.start_window[route_customer_id] - ctoctime);
+		}
+
+		current_time = max(current_time + ctoctime, data.start_window[route_customer_id]);
+		driving_time += ctoctime;
+		frame_error += max(0.0, current_time - data.end_window[route_customer_id]);
+		current_time += data.service_times[route_customer_id];
+
+		prefix.departure_times[route_pos] = current_time;
+		prefix.driving_times[route_pos] = driving_time;
+		prefix.frame_errors[route_pos] = frame_error;
+
+		prev_node_id = route_customer_id + 1;
+	}
+	return true;
+}
+
+/**
+Get the cost (change of the solution quality) of inserting the prefix customer
+at [ins_pos] without changing the route.
+
+Process:
+	1) Take the shifted prefix in front of the insertion position
+	2) Add the arcs to and from the new customer
+	3) Propagate the delay through the succeeding customers until it is absorbed
+		(waiting times, slack) -> the remaining frame error is known from the summaries
+
+Annotation:
+	The succeeding loads are not changed by the insertion.
+	Their driving times are therefore known as well.
+
+@param prefix					Prefix of the customer and route (set_insertion_prefix)
+@param ins_pos					Insertion position at the prefix route
+@param capa_error_weight:		Weight for the capacity error (for quality calculation)
+@param frame_error_weight:		Weight for the frame error (for quality calculation)
+*/
+double Solution::get_insertion_cost(
+	const InsertionPrefix &prefix,
+	const int ins_pos,
+	const double capa_error_weight,
+	const double frame_error_weight) const
+{
+	ALNSData &data = this->data_obj.get();
+	const vector<int> &route = this->solution_representation[prefix.route_id];
+	const int customer_id = prefix.customer_id;
+	const int r_size = route.size();
+
+	// 1) Load level of the new customer (demand of all succeeding customers)
+	double customer_load = data.demand[customer_id];
+	if (ins_pos < r_size) {
+		customer_load += this->loads[route[ins_pos]];
+	}
+	int load_level = route_evaluate::get_load_bucket(customer_load, data.load_bucket_size);
+
+	// 2) Arrival at the new customer
+	int prev_node_id = (ins_pos > 0) ? route[ins_pos - 1] + 1 : 0;
+	double ctoctime = data.time_cube(load_level, prev_node_id, customer_id + 1);
+
+	double current_time;
+	double driving_time = ctoctime;
+	double frame_error = 0;
+
+	if (ins_pos > 0) {
+		current_time = prefix.departure_times[ins_pos - 1];
+		driving_time += prefix.driving_times[ins_pos - 1];
+		frame_error += prefix.frame_errors[ins_pos - 1];
+	}
+	else {
+		current_time = max(0.0, data.start_window[customer_id] - ctoctime);
+	}
+
+	current_time = max(current_time + ctoctime, data.start_window[customer_id]);
+	frame_error += max(0.0, current_time - data.end_window[customer_id]);
+	current_time += data.service_times[customer_id];
+
+	// 3) Succeeding customers
+	if (ins_pos < r_size) {
+		int next_customer_id = route[ins_pos];
+		double next_time = data.time_cube(this->load_levels[next_customer_id], customer_id + 1, next_customer_id + 1);
+
+		// driving time of the new arc and the unchanged suffix
+		driving_time += next_time + this->route_driving_times[prefix.route_id] - this->prefix_driving_times[next_customer_id];
+
+		frame_error = this->propagate_insertion_delay(prefix.route_id, ins_pos, current_time, next_time, frame_error);
+	}
+	else {
+		// back to the depot
+		driving_time += data.time_cube(0, customer_id + 1, 0);
+	}
+
+	double route_quality = route_evaluate::get_quality(driving_time, prefix.capa_error, frame_error, capa_error_weight, frame_error_weight);
+	return route_quality - this->route_qualities[prefix.route_id];
+}
+
+/**
+Propagate the delay of an insertion through the succeeding customers [ins_pos, route end]
+until it is absorbed (waiting times, slack) -> the remaining frame error is known from the summaries
+
+@param current_time				Departure at the new customer
+@param next_time				Time of the arc (new customer -> customer at ins_pos)
+@param frame_error				Frame error up to (including) the new customer
+@return							Frame error of the changed route
+*/
+double Solution::propagate_insertion_delay(
+	const int route_id,
+	const int ins_pos,
+	double current_time,
+	double next_time,
+	double frame_error) const
+{
+	ALNSData &data = this->data_obj.get();
+	const vector<int> &route = this->solution_representation[route_id];
+	const int r_size = route.size();
+
+	for (int route_pos = ins_pos; route_pos < r_size; route_pos++) {
+		int route_customer_id = route[route_pos];
+		current_time = max(current_time + next_time, data.start_window[route_customer_id]);
+
+		double delay = current_time - this->arrival_times[route_customer_id];
+
+		if ((delay >= 0) && (delay <= this->time_slacks[route_customer_id])) {
+			// delay is absorbed -> remaining frame error does not change
+			frame_error += this->suffix_frame_errors[route_customer_id];
+			break;
+		}
+		else if ((delay < 0) && (this->suffix_frame_errors[route_customer_id] == 0)) {
+			// earlier arrival without remaining frame error -> nothing changes
+			break;
+		}
+
+		frame_error += max(0.0, current_time - data.end_window[route_customer_id]);
+		current_time += data.service_times[route_customer_id];
+
+		if (route_pos + 1 < r_size) {
+			int succ_customer_id = route[route_pos + 1];
+			next_time = data.time_cube(this->load_levels[succ_customer_id], route_customer_id + 1, succ_customer_id + 1);
 		}
 	}
+	return frame_error;
+}
+
+/**
+Batch loops of Solution::get_insertion_costs (position based arrays)
 
-	return diversity / diversity_norm;
+The output arrays are restrict parameters -> no aliasing with the inputs
+and the loops are vectorized by the compiler (time cube lookups are gathers).
+Compressed time cubes are read via the accessor (arc run lookup per position).
+*/
+void batch_arrival_arcs(
+	const int r_size,
+	const int *customers,
+	const double *loads,
+	const double demand,
+	const double load_bucket_size,
+	const TimeCube &time_cube,
+	const size_t node_id,
+	double * __restrict arc_times)
+{
+	// positions [1, route size): predecessor and successor within the route
+	const double *cube = time_cube.data();
+	const size_t stride_bucket = time_cube.get_stride_bucket();
+	const size_t stride_from = time_cube.get_stride_from();
+	const size_t stride_to = time_cube.get_stride_to();
+
+	if (time_cube.is_compressed()) {
+		for (int pos = 1; pos < r_size; pos++) {
+			int load_level = route_evaluate::get_load_bucket(demand + loads[customers[pos]], load_bucket_size);
+			arc_times[pos] = time_cube(load_level, customers[pos - 1] + 1, int(node_id));
+		}
+		return;
+	}
+
+	for (int pos = 1; pos < r_size; pos++) {
+		size_t load_level = route_evaluate::get_load_bucket(demand + loads[customers[pos]], load_bucket_size);
+		size_t prev_node_id = customers[pos - 1] + 1;
+		arc_times[pos] = cube[load_level*stride_bucket + prev_node_id*stride_from + node_id*stride_to];
+	}
+}
+
+void batch_visits(
+	const int r_size,
+	const double *departure_times,
+	const double *driving_times,
+	const double *frame_errors,
+	const double *arc_times,
+	const double start_window,
+	const double end_window,
+	const double service_time,
+	double * __restrict start_times,
+	double * __restrict new_driving_times,
+	double * __restrict new_frame_errors)
+{
+	// positions [1, route size]: predecessor within the route
+	for (int pos = 1; pos <= r_size; pos++) {
+		double current_time = max(departure_times[pos - 1] + arc_times[pos], start_window);
+		new_frame_errors[pos] = frame_errors[pos - 1] + max(0.0, current_time - end_window);
+		start_times[pos] = current_time + service_time;
+		new_driving_times[pos] = arc_times[pos] + driving_times[pos - 1];
+	}
+}
+
+void batch_departure_arcs(
+	const int r_size,
+	const int *customers,
+	const int *load_levels,
+	const double *prefix_driving_times,
+	const double route_driving_time,
+	const TimeCube &time_cube,
+	const size_t node_id,
+	double * __restrict next_times,
+	double * __restrict new_driving_times)
+{
+	// positions [0, route size): successor within the route (unchanged load level and suffix)
+	const double *cube = time_cube.data();
+	const size_t stride_bucket = time_cube.get_stride_bucket();
+	const size_t stride_from = time_cube.get_stride_from();
+	const size_t stride_to = time_cube.get_stride_to();
+
+	if (time_cube.is_compressed()) {
+		for (int pos = 0; pos < r_size; pos++) {
+			double next_time = time_cube(load_levels[customers[pos]], int(node_id), customers[pos] + 1);
+			next_times[pos] = next_time;
+			new_driving_times[pos] += next_time + route_driving_time - prefix_driving_times[customers[pos]];
+		}
+		return;
+	}
+
+	for (int pos = 0; pos < r_size; pos++) {
+		size_t next_node_id = customers[pos] + 1;
+		double next_time = cube[load_levels[customers[pos]]*stride_bucket + node_id*stride_from + next_node_id*stride_to];
+		next_times[pos] = next_time;
+		new_driving_times[pos] += next_time + route_driving_time - prefix_driving_times[customers[pos]];
+	}
+}
+
+/**
+Get the costs of inserting the prefix customer at all positions [0, route size] in one pass
+(same values as get_insertion_cost for each position)
+
+Process:
+	1) Arcs to the new customer for all positions (load levels, time cube gathers)
+	2) Visit of the new customer and arcs to the successors for all positions
+	3) Delay propagation through the succeeding customers per position (stops early)
+
+Pruning (step 3):
+	The driving time and the capacity error of each position are exact after 2),
+	the frame error up to (including) the new customer is a lower bound (the
+	propagation only adds errors, the weights are positive). Positions whose
+	lower bound is not below [max_cost] cannot be among the best positions
+	-> skipped without the propagation (cost max double).
+	A late arrival at the new customer (end window) is part of the bound.
+
+Annotation:
+	The steps 1) and 2) are independent per position and run as flat loops
+	without calls or early exits (see batch_arrival_arcs) -> vectorized.
+	Only step 3) remains sequential.
+
+@param prefix					Prefix of the customer and route (set_insertion_prefix)
+								Output: prefix.costs (max double for skipped positions)
+@param capa_error_weight:		Weight for the capacity error (for quality calculation)
+@param frame_error_weight:		Weight for the frame error (for quality calculation)
+@param is_candidate				Customer based (granular neighbourhood): only evaluate positions
+								with a candidate predecessor or successor (nullptr: all positions)
+@param max_cost					Prune all positions with a lower bound >= max_cost (e.g. the current k-th best)
+@param update_max_cost			Lower max_cost to each evaluated cost (only the best position is needed)
+*/
+void Solution::get_insertion_costs(
+	InsertionPrefix &prefix,
+	const double capa_error_weight,
+	const double frame_error_weight,
+	const vector<bool> *is_candidate,
+	double max_cost,
+	const bool update_max_cost) const
+{
+	ALNSData &data = this->data_obj.get();
+	const vector<int> &route = this->solution_representation[prefix.route_id];
+	const int r_size = route.size();
+	const int customer_id = prefix.customer_id;
+	const size_t node_id = customer_id + 1;
+
+	prefix.arc_times.resize(r_size + 1);
+	prefix.next_times.resize(r_size + 1);
+	prefix.start_times.resize(r_size + 1);
+	prefix.route_driving_times.resize(r_size + 1);
+	prefix.route_frame_errors.resize(r_size + 1);
+	prefix.costs.resize(r_size + 1);
+
+	// 1) Arcs to the new customer (load level: demand of all succeeding customers)
+	// first position from the depot, last position without succeeding customers
+	batch_arrival_arcs(r_size,
+		route.data(),
+		this->loads.data(),
+		data.demand[customer_id],
+		data.load_bucket_size,
+		data.time_cube,
+		node_id,
+		prefix.arc_times.data());
+
+	double first_load = data.demand[customer_id] + ((r_size > 0) ? this->loads[route[0]] : 0);
+	prefix.arc_times[0] = data.time_cube(route_evaluate::get_load_bucket(first_load, data.load_bucket_size), 0, customer_id + 1);
+
+	if (r_size > 0) {
+		int last_load_level = route_evaluate::get_load_bucket(data.demand[customer_id], data.load_bucket_size);
+		prefix.arc_times[r_size] = data.time_cube(last_load_level, route[r_size - 1] + 1, customer_id + 1);
+	}
+
+	// 2) Visit of the new customer (see get_insertion_cost)
+	batch_visits(r_size,
+		prefix.departure_times.data(),
+		prefix.driving_times.data(),
+		prefix.frame_errors.data(),
+		prefix.arc_times.data(),
+		data.start_window[customer_id],
+		data.end_window[customer_id],
+		data.service_times[customer_id],
+		prefix.start_times.data(),
+		prefix.route_driving_times.data(),
+		prefix.route_frame_errors.data());
+
+	double current_time = max(0.0, data.start_window[customer_id] - prefix.arc_times[0]);
+	current_time = max(current_time + prefix.arc_times[0], data.start_window[customer_id]);
+	prefix.route_frame_errors[0] = max(0.0, current_time - data.end_window[customer_id]);
+	prefix.start_times[0] = current_time + data.service_times[customer_id];
+	prefix.route_driving_times[0] = prefix.arc_times[0];
+
+	// 2.1) Arcs to the successors and the unchanged suffix (last position: back to the depot)
+	batch_departure_arcs(r_size,
+		route.data(),
+		this->load_levels.data(),
+		this->prefix_driving_times.data(),
+		this->route_driving_times[prefix.route_id],
+		data.time_cube,
+		node_id,
+		prefix.next_times.data(),
+		prefix.route_driving_times.data());
+
+	prefix.route_driving_times[r_size] += data.time_cube(0, customer_id + 1, 0);
+
+	// 3) Delay propagation and costs (pruned by the lower bound)
+	const double route_quality = this->route_qualities[prefix.route_id];
+
+	for (int pos = 0; pos <= r_size; pos++) {
+		// Predecessor or successor must be a candidate
+		if ((is_candidate != nullptr)
+			&& !((pos > 0) && (*is_candidate)[route[pos - 1]])
+			&& !((pos < r_size) && (*is_candidate)[route[pos]])) {
+			prefix.costs[pos] = numeric_limits<double>::max();
+			continue;
+		}
+
+		double frame_error = prefix.route_frame_errors[pos];
+		double lower_bound = route_evaluate::get_quality(prefix.route_driving_times[pos], prefix.capa_error, frame_error, capa_error_weight, frame_error_weight) - route_quality;
+
+		if (!(lower_bound < max_cost)) {
+			prefix.costs[pos] = numeric_limits<double>::max();
+			continue;
+		}
+
+		if (pos < r_size) {
+			frame_error = this->propagate_insertion_delay(prefix.route_id, pos, prefix.start_times[pos], prefix.next_times[pos], frame_error);
+		}
+
+		double cost = route_evaluate::get_quality(prefix.route_driving_times[pos], prefix.capa_error, frame_error, capa_error_weight, frame_error_weight) - route_quality;
+		prefix.costs[pos] = cost;
+
+		if (update_max_cost && (cost < max_cost)) {
+			max_cost = cost;
+		}
+	}
 }
@@ -1,18 +1,68 @@
 #pragma once
 #include "alns_data.h"
+#include "fingerprint.h"
 #include <vector>
 #include <exception>
+#include <limits>
+
+/**
+Shifted route prefix of a planned insertion (see Solution::set_insertion_prefix)
+
+If a customer is inserted into a route all preceding customers carry its demand.
+Their load levels and therefore their visit times change. This is independent
+of the exact insertion position and computed once per customer and route.
+
+All vectors are route position based!
+*/
+struct InsertionPrefix {
+	int customer_id = -1;
+	int route_id = -1;
+	double capa_error = 0;				// Route capacity error after the insertion
+	std::vector<double> departure_times;	// Departure at each position with shifted loads
+	std::vector<double> driving_times;		// Driving time up to the arrival at each position
+	std::vector<double> frame_errors;		// Frame error up to (including) each position
+
+	// Batch evaluation of all insertion positions [0, route size] (see Solution::get_insertion_costs)
+	std::vector<double> arc_times;			// Time of the arc (predecessor -> new customer)
+	std::vector<double> next_times;			// Time of the arc (new customer -> successor)
+	std::vector<double> start_times;		// Departure at the new customer
+	std::vector<double> route_driving_times;// Driving time of the changed route
+	std::vector<double> route_frame_errors;	// Frame error up to (including) the new customer
+	std::vector<double> costs;				// Insertion cost (max double: not evaluated or pruned)
+};
 
 class Solution {
 private:
 	// evaluation functions
 	void set_chromosomes();
+	void set_fingerprints();
+	void update_fingerprint(const int route_id);
 	void set_load_levels();
 	void set_solution_time();
 	void set_capa_error();
 	void set_frame_error();
 	void set_is_feasible();
 
+	// change journal
+	std::vector<int> dirty_routes;		// Routes changed since the last commit / rollback
+	std::vector<bool> route_is_dirty;	// Route based flag (avoid duplicates in dirty_routes)
+
+	void mark_dirty(const int route_id);
+	void mark_all_dirty();
+	void copy_routes(const Solution &obj, const std::vector<int> &route_ids);
+
+	// delay propagation of an insertion (see get_insertion_cost)
+	double propagate_insertion_delay(
+		const int route_id,
+		const int ins_pos,
+		double current_time,
+		double next_time,
+		double frame_error) const;
+
+	// batched removal (see remove_customers)
+	std::vector<int> removal_route_ids; // Scratch list of the changed routes (kept for its capacity)
+	void evaluate_route(const int route_id);
+
 public:
 	// ATTRIBUTES
 	// The data object to which the solution belongs
@@ -22,6 +72,7 @@ public:
 	// Each integer represents a customer id starting from 0 and going to nr_customers -1
 	std::vector<std::vector<int>> solution_representation;
 	std::vector<int> route_chromosome;
+	std::vector<int> route_positions; // Customer based position in its route (-1: removed by remove_customers)
 
 	// Customer based info
 	std::vector<double> loads;
@@ -29,6 +80,15 @@ public:
 	std::vector<double> arrival_times;
 	std::vector<double> departure_times;
 
+	// Customer based route segment summaries (for insertion evaluation)
+	std::vector<double> prefix_driving_times;	// Driving time from the depot up to the customer
+	std::vector<double> suffix_frame_errors;	// Frame error of the customer and all succeeding
+	std::vector<double> time_slacks;			// Max arrival delay without a frame error change
+
+	// Fingerprint of the solution (visited solution tracking)
+	Fingerprint fingerprint;						// XOR of all route fingerprints
+	std::vector<Fingerprint> route_fingerprints;
+
 	// KPIs of the a solution	// 
 	double driving_time;			// 1) Driving time of all routes			
 	double capa_error = 0.0;		// 2) Capacity error (capped at a certain max)
@@ -43,6 +103,10 @@ public:
 	std::vector<double> route_frame_errors;
 	std::vector<double> route_qualities;
 
+	// Evaluation counters of this object (instrumentation only, not copied by the assignment)
+	std::int64_t nr_evaluated_changes = 0;
+	std::int64_t nr_rejected_changes = 0; // max capa infeasibility exceeded
+
 	// FUNCTIONS
 	// Base constructor
 	Solution(ALNSData &data_obj) : data_obj(data_obj){this->driving_time = std::numeric_limits<double>::max();}; // Default constructor (for init)
@@ -87,7 +151,45 @@ public:
 		const double capa_error_weight,
 		const double frame_error_weight);
 
-	double get_diversity(std::vector<std::vector<int>> &node_pair_useage_matrix, int iteration);
+	// Non throwing evaluate_change: false if the max capa error is exceeded (same object state)
+	bool try_evaluate_change(
+		const int route_id,
+		const int ins_pos,
+		const double capa_error_weight,
+		const double frame_error_weight);
+
+	// Remove customers and reevaluate only their routes (instead of evaluate_solution)
+	void remove_customers(
+		const std::vector<int> &customer_ids,
+		const double capa_error_weight,
+		const double frame_error_weight);
+
+	// O(1) check of an insertion of [additional_demand] into [route_id] (head load of the route)
+	bool exceeds_max_capa_error(const int route_id, const double additional_demand) const;
+
+	bool set_insertion_prefix(
+		const int customer_id,
+		const int route_id,
+		InsertionPrefix &prefix) const;
+
+	double get_insertion_cost(
+		const InsertionPrefix &prefix,
+		const int ins_pos,
+		const double capa_error_weight,
+		const double frame_error_weight) const;
+
+	void get_insertion_costs(
+		InsertionPrefix &prefix,
+		const double capa_error_weight,
+		const double frame_error_weight,
+		const std::vector<bool> *is_candidate = nullptr,
+		double max_cost = std::numeric_limits<double>::max(),
+		const bool update_max_cost = false) const;
+
+	// Change journal (copy only the routes changed by the last operators)
+	void commit_journal(Solution &obj);
+	void rollback_journal(const Solution &obj);
+	void clear_journal();
 
 };
 
@@ -0,0 +1,361 @@
+/**
+This file contains the (cold) construction and conversion functions
+of the flat time cube.
+
+The hot accessors are defined inline in the header.
+*/
+#include "time_cube.h"
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+Allocate a cube with the given dimensions (all values 0)
+Only for the dense layouts (compressed cubes: see from_rows)
+*/
+TimeCube::TimeCube(int nr_buckets, int nr_nodes, Layout layout) :
+	nr_buckets(nr_buckets),
+	nr_nodes(nr_nodes),
+	layout(layout),
+	values(size_t(nr_buckets)*nr_nodes*nr_nodes, 0.0)
+{
+	if (layout == COMPRESSED) {
+		throw invalid_argument("A compressed time cube cannot be allocated (use from_rows or set_layout)");
+	}
+	this->set_strides();
+	this->set_base();
+}
+
+/**
+Conversion constructor from the nested form [bucket][from][to]
+(VRPTW constructor and pickling, compressed cubes are compressed after the conversion)
+*/
+TimeCube::TimeCube(const vector<vector<vector<double>>> &nested, Layout layout) :
+	nr_buckets(int(nested.size())),
+	nr_nodes(nested.size() > 0 ? int(nested[0].size()) : 0),
+	layout(layout == COMPRESSED ? BUCKET_MAJOR : layout),
+	values(size_t(nested.size())*(nested.size() > 0 ? nested[0].size()*nested[0].size() : 0), 0.0)
+{
+	this->set_strides();
+	this->set_base();
+
+	for (int bucket = 0; bucket < this->nr_buckets; bucket++) {
+		if (int(nested[bucket].size()) != this->nr_nodes) {
+			throw invalid_argument("The time cube must be of dimension [bucket][node][node]");
+		}
+
+		for (int i = 0; i < this->nr_nodes; i++) {
+			if (int(nested[bucket][i].size()) != this->nr_nodes) {
+				throw invalid_argument("The time cube must be of dimension [bucket][node][node]");
+			}
+
+			for (int j = 0; j < this->nr_nodes; j++) {
+				this->at(bucket, i, j) = nested[bucket][i][j];
+			}
+		}
+	}
+	this->set_layout(layout);
+}
+
+/**
+Copy and move operations (the base pointer must point to the own buffer)
+*/
+TimeCube::TimeCube(const TimeCube &other) :
+	nr_buckets(other.nr_buckets),
+	nr_nodes(other.nr_nodes),
+	layout(other.layout),
+	stride_bucket(other.stride_bucket),
+	stride_from(other.stride_from),
+	stride_to(other.stride_to),
+	values(other.values),
+	arc_runs(other.arc_runs),
+	base(other.base),
+	external_owner(other.external_owner)
+{
+	this->set_base();
+}
+
+TimeCube::TimeCube(TimeCube &&other) :
+	nr_buckets(other.nr_buckets),
+	nr_nodes(other.nr_nodes),
+	layout(other.layout),
+	stride_bucket(other.stride_bucket),
+	stride_from(other.stride_from),
+	stride_to(other.stride_to),
+	values(std::move(other.values)),
+	arc_runs(std::move(other.arc_runs)),
+	base(other.base),
+	external_owner(std::move(other.external_owner))
+{
+	this->set_base();
+	other.clear_moved();
+}
+
+TimeCube& TimeCube::operator=(const TimeCube &other) {
+	if (&other != this) {
+		this->nr_buckets = other.nr_buckets;
+		this->nr_nodes = other.nr_nodes;
+		this->layout = other.layout;
+		this->stride_bucket = other.stride_bucket;
+		this->stride_from = other.stride_from;
+		this->stride_to = other.stride_to;
+		this->values = other.values;
+		this->arc_runs = other.arc_runs;
+		this->base = other.base;
+		this->external_owner = other.external_owner;
+		this->set_base();
+	}
+	return *this;
+}
+
+TimeCube& TimeCube::operator=(TimeCube &&other) {
+	if (&other != this) {
+		this->nr_buckets = other.nr_buckets;
+		this->nr_nodes = other.nr_nodes;
+		this->layout = other.layout;
+		this->stride_bucket = other.stride_bucket;
+		this->stride_from = other.stride_from;
+		this->stride_to = other.stride_to;
+		this->values = std::move(other.values);
+		this->arc_runs = std::move(other.arc_runs);
+		this->base = other.base;
+		this->external_owner = std::move(other.external_owner);
+		this->set_base();
+		other.clear_moved();
+	}
+	return *this;
+}
+
+/**
+View of an external buffer (e.g. memory mapped file)
+
+@param data:	Start of nr_buckets*nr_nodes*nr_nodes values in the given (dense) layout
+@param owner:	Keeps the buffer alive as long as any cube views it
+*/
+TimeCube TimeCube::from_external(const double *data,
+	int nr_buckets,
+	int nr_nodes,
+	Layout layout,
+	shared_ptr<const void> owner)
+{
+	if (layout != BUCKET_MAJOR && layout != ARC_MAJOR) {
+		throw invalid_argument("Only dense time cubes can view an external buffer");
+	}
+
+	TimeCube cube;
+	cube.nr_buckets = nr_buckets;
+	cube.nr_nodes = nr_nodes;
+	cube.layout = layout;
+	cube.set_strides();
+
+	cube.external_owner = owner;
+	cube.base = const_cast<double*>(data); // read only (see header)
+	return cube;
+}
+
+/**
+Leave a moved from cube as valid empty cube
+*/
+void TimeCube::clear_moved() {
+	this->nr_buckets = 0;
+	this->nr_nodes = 0;
+	this->values.clear();
+	this->external_owner.reset();
+	this->base = nullptr;
+	this->arc_runs.clear();
+	this->layout = BUCKET_MAJOR;
+	this->set_strides();
+}
+
+/**
+Point to the own buffer (the external buffer is kept)
+*/
+void TimeCube::set_base() {
+	if (this->external_owner == nullptr) {
+		this->base = this->values.data();
+	}
+}
+
+/**
+Set the index strides based on the layout
+*/
+void TimeCube::set_strides() {
+	size_t nodes = size_t(this->nr_nodes);
+	size_t buckets = size_t(this->nr_buckets);
+
+	if (this->layout == COMPRESSED) {
+		this->stride_bucket = 0;
+		this->stride_from = 0;
+		this->stride_to = 0;
+	}
+	else if (this->layout == ARC_MAJOR) {
+		this->stride_bucket = 1;
+		this->stride_from = nodes * buckets;
+		this->stride_to = buckets;
+	}
+	else {
+		this->stride_bucket = nodes * nodes;
+		this->stride_from = nodes;
+		this->stride_to = 1;
+	}
+}
+
+/**
+Transform the buffer into a new layout
+
+Annotation:
+	Requires a temporary copy of the cube. Should only be done once after preprocessing.
+*/
+void TimeCube::set_layout(Layout new_layout) {
+	if (new_layout == this->layout) {
+		return;
+	}
+
+	if (new_layout == COMPRESSED) {
+		vector<vector<double>> row_values(this->nr_nodes);
+		vector<vector<ArcRun>> row_runs(this->nr_nodes, vector<ArcRun>(this->nr_nodes));
+		vector<double> times(this->nr_buckets);
+
+		for (int i = 0; i < this->nr_nodes; i++) {
+			for (int j = 0; j < this->nr_nodes; j++) {
+				for (int bucket = 0; bucket < this->nr_buckets; bucket++) {
+					times[bucket] = (*this)(bucket, i, j);
+				}
+				row_runs[i][j] = append_arc(row_values[i], times.data(), 1, this->nr_buckets);
+			}
+		}
+
+		*this = from_rows(this->nr_buckets, this->nr_nodes, row_values, row_runs);
+		return;
+	}
+
+	TimeCube reordered(this->nr_buckets, this->nr_nodes, new_layout);
+
+	for (int bucket = 0; bucket < this->nr_buckets; bucket++) {
+		for (int i = 0; i < this->nr_nodes; i++) {
+			for (int j = 0; j < this->nr_nodes; j++) {
+				reordered.at(bucket, i, j) = (*this)(bucket, i, j);
+			}
+		}
+	}
+
+	*this = reordered;
+}
+
+/**
+Number of stored values
+*/
+size_t TimeCube::size() const {
+	if (this->layout == COMPRESSED) {
+		return this->values.size();
+	}
+	return size_t(this->nr_buckets)*this->nr_nodes*this->nr_nodes;
+}
+
+/**
+Append the run of one arc to its row
+
+The arc is load invariant if the travel times of all buckets are equal
+(bitwise, e.g. downhill arcs or distance 0) -> a single value.
+*/
+TimeCube::ArcRun TimeCube::append_arc(vector<double> &row_values, const double *times, size_t stride, int nr_buckets) {
+	ArcRun run = { uint32_t(row_values.size()), 0 };
+
+	for (int bucket = 1; bucket < nr_buckets; bucket++) {
+		if (times[bucket*stride] != times[0]) {
+			run.bucket_mask = -1;
+			break;
+		}
+	}
+
+	int nr_values = (run.bucket_mask == 0) ? 1 : nr_buckets;
+	for (int bucket = 0; bucket < nr_values; bucket++) {
+		row_values.push_back(times[bucket*stride]);
+	}
+	return run;
+}
+
+/**
+Compressed cube from the rows of the arcs (e.g. built in parallel, see get_time_cube)
+
+Annotation:
+	The offsets are 32 bit -> at most 2^32 stored values (32 GB)
+
+@param row_values:	Values of each row (released)
+@param row_runs:	Runs of each arc [from][to] relative to the values of the row
+*/
+TimeCube TimeCube::from_rows(int nr_buckets,
+	int nr_nodes,
+	vector<vector<double>> &row_values,
+	const vector<vector<ArcRun>> &row_runs)
+{
+	if (int(row_values.size()) != nr_nodes || int(row_runs.size()) != nr_nodes) {
+		throw invalid_argument("The compressed time cube needs the values and runs of all rows");
+	}
+
+	size_t nr_values = 0;
+	for (const vector<double> &values : row_values) {
+		nr_values += values.size();
+	}
+	if (nr_values > size_t(numeric_limits<uint32_t>::max())) {
+		throw length_error("The compressed time cube exceeds 2^32 values");
+	}
+
+	TimeCube cube;
+	cube.nr_buckets = nr_buckets;
+	cube.nr_nodes = nr_nodes;
+	cube.layout = COMPRESSED;
+	cube.set_strides();
+
+	cube.values.reserve(nr_values);
+	cube.arc_runs.resize(size_t(nr_nodes)*nr_nodes);
+
+	for (int i = 0; i < nr_nodes; i++) {
+		if (int(row_runs[i].size()) != nr_nodes) {
+			throw invalid_argument("The compressed time cube needs the runs of all arcs");
+		}
+
+		uint32_t row_offset = uint32_t(cube.values.size());
+		for (int j = 0; j < nr_nodes; j++) {
+			ArcRun run = row_runs[i][j];
+			run.offset += row_offset;
+			cube.arc_runs[size_t(i)*nr_nodes + j] = run;
+		}
+
+		cube.values.insert(cube.values.end(), row_values[i].begin(), row_values[i].end());
+		vector<double>().swap(row_values[i]);
+	}
+
+	cube.set_base();
+	return cube;
+}
+
+/**
+Get the nested representation [bucket][from][to]
+Needed for the python interface and pickling
+*/
+vector<vector<vector<double>>> TimeCube::to_nested() const {
+	vector<vector<vector<double>>> nested(this->nr_buckets);
+
+	for (int bucket = 0; bucket < this->nr_buckets; bucket++) {
+		nested[bucket] = this->slice(bucket);
+	}
+	return nested;
+}
+
+/**
+Get a single load slice as matrix [from][to]
+*/
+vector<vector<double>> TimeCube::slice(int bucket) const {
+	vector<vector<double>> matrix(this->nr_nodes, vector<double>(this->nr_nodes));
+
+	for (int i = 0; i < this->nr_nodes; i++) {
+		for (int j = 0; j < this->nr_nodes; j++) {
+			matrix[i][j] = (*this)(bucket, i, j);
+		}
+	}
+	return matrix;
+}
@@ -0,0 +1,218 @@
+/**
+Flat storage of the load dependent travel times
+
+All travel times are kept in one contiguous and aligned buffer instead of
+nested vectors. The indexing is done via strides so that the same accessor
+can serve both supported memory layouts:
+
+	1) BUCKET_MAJOR:	[bucket][from][to] (default, one load slice is contiguous)
+	2) ARC_MAJOR:		[from][to][bucket] (all buckets of one hop are contiguous)
+	3) COMPRESSED:		[from][to] -> run of the arc (arc major, only the value of bucket 0
+						if the arc is load invariant, e.g. downhill arcs driven at max speed)
+
+The compressed layout keeps a table with one run per arc (offset, bucket mask).
+Load invariant arcs have the mask 0 -> every bucket reads the single value.
+
+The cube either owns its buffer or views an external read only buffer
+(e.g. a memory mapped data file, see ALNSData::load_mmap) that is kept alive by the cube.
+
+Annotation:
+	The accessor is the hottest function of the evaluation.
+	It must stay inline and branch free within a layout! The layout test is constant
+	per cube and therefore always predicted (cheaper than a run lookup for dense cubes).
+Annotation2:
+	The mutable accessors (at, row) and the raw strides are only valid in the dense layouts.
+*/
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace tools {
+	/**
+	Minimal allocator that aligns the buffer start to [Alignment] bytes
+	(cache line and vector register friendly).
+	*/
+	template <typename T, std::size_t Alignment = 64>
+	struct AlignedAllocator {
+		typedef T value_type;
+
+		template <typename U>
+		struct rebind { typedef AlignedAllocator<U, Alignment> other; };
+
+		AlignedAllocator() {}
+
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+		T* allocate(std::size_t n) {
+			// over allocate and remember the original pointer right before the aligned block
+			void *raw = ::operator new(n * sizeof(T) + Alignment + sizeof(void*));
+			std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+			std::uintptr_t aligned = (start + Alignment - 1) & ~(std::uintptr_t(Alignment) - 1);
+			reinterpret_cast<void**>(aligned)[-1] = raw;
+			return reinterpret_cast<T*>(aligned);
+		}
+
+		void deallocate(T *p, std::size_t) {
+			if (p != nullptr) {
+				::operator delete(reinterpret_cast<void**>(p)[-1]);
+			}
+		}
+
+		template <typename U>
+		bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+
+		template <typename U>
+		bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+	};
+}
+
+class TimeCube {
+public:
+	enum Layout { BUCKET_MAJOR = 0, ARC_MAJOR = 1, COMPRESSED = 2 };
+
+	// Values of one arc in the compressed layout: values[offset + (bucket & bucket_mask)]
+	struct ArcRun {
+		std::uint32_t offset;
+		std::int32_t bucket_mask; // -1: one value per bucket, 0: load invariant (one value)
+	};
+
+private:
+	int nr_buckets;
+	int nr_nodes;
+	Layout layout;
+
+	// strides of the current layout
+	std::size_t stride_bucket;
+	std::size_t stride_from;
+	std::size_t stride_to;
+
+	std::vector<double, tools::AlignedAllocator<double>> values;
+
+	// Runs of the arcs [from][to] (only compressed)
+	std::vector<ArcRun> arc_runs;
+
+	// Start of the buffer (values or the external buffer)
+	double *base = nullptr;
+	std::shared_ptr<const void> external_owner; // Keeps an external buffer alive (empty if owned)
+
+	void set_strides();
+	void set_base();
+	void clear_moved();
+
+public:
+	// Default constructor (empty cube)
+	TimeCube() : nr_buckets(0), nr_nodes(0), layout(BUCKET_MAJOR) { this->set_strides(); };
+
+	TimeCube(const TimeCube &other);
+	TimeCube(TimeCube &&other);
+	TimeCube& operator=(const TimeCube &other);
+	TimeCube& operator=(TimeCube &&other);
+
+	// Allocate a cube filled with 0s
+	TimeCube(int nr_buckets, int nr_nodes, Layout layout = BUCKET_MAJOR);
+
+	// Conversion from the nested (python / pickle) form [bucket][from][to]
+	explicit TimeCube(const std::vector<std::vector<std::vector<double>>> &nested, Layout layout = BUCKET_MAJOR);
+
+	/**
+	View of an external buffer of nr_buckets*nr_nodes*nr_nodes values (no copy)
+	The buffer is read only: at() and the mutable row() must not be used!
+	Only the dense layouts can be viewed.
+	*/
+	static TimeCube from_external(const double *data,
+		int nr_buckets,
+		int nr_nodes,
+		Layout layout,
+		std::shared_ptr<const void> owner);
+
+	/**
+	Compressed cube from the runs of all rows (see append_arc)
+	The offsets of [row_runs] are relative to the values of their row.
+	The rows are released while they are copied.
+	*/
+	static TimeCube from_rows(int nr_buckets,
+		int nr_nodes,
+		std::vector<std::vector<double>> &row_values,
+		const std::vector<std::vector<ArcRun>> &row_runs);
+
+	/**
+	Append the travel times of one arc to the values of its row
+	(only the first value if all buckets are equal)
+
+	@param times:	Travel time of bucket b at times[b*stride]
+	@return			Run of the arc (offset relative to the row)
+	*/
+	static ArcRun append_arc(std::vector<double> &row_values, const double *times, std::size_t stride, int nr_buckets);
+
+	// Travel time of the arc (from, to) with load level [bucket]
+	inline double operator()(int bucket, int from, int to) const {
+		return this->base[this->index(bucket, from, to)];
+	}
+
+	// Position of the travel time in data() (all layouts)
+	inline std::size_t index(int bucket, int from, int to) const {
+		if (this->layout == COMPRESSED) {
+			const ArcRun &run = this->arc_runs[std::size_t(from)*this->nr_nodes + to];
+			return run.offset + std::size_t(bucket & run.bucket_mask);
+		}
+		return bucket*this->stride_bucket + from*this->stride_from + to*this->stride_to;
+	}
+
+	inline double& at(int bucket, int from, int to) {
+		return this->base[bucket*this->stride_bucket + from*this->stride_from + to*this->stride_to];
+	}
+
+	/**
+	Contiguous row of a load slice (bucket, from, 0..nr_nodes-1)
+	Only valid in BUCKET_MAJOR layout!
+	*/
+	inline const double* row(int bucket, int from) const {
+		return this->base + bucket*this->stride_bucket + from*this->stride_from;
+	}
+
+	inline double* row(int bucket, int from) {
+		return this->base + bucket*this->stride_bucket + from*this->stride_from;
+	}
+
+	/**
+	Contiguous buckets of one arc (0..nr_buckets-1, from, to)
+	Only valid in ARC_MAJOR layout!
+	*/
+	inline const double* arc(int from, int to) const {
+		return this->base + from*this->stride_from + to*this->stride_to;
+	}
+
+	int get_nr_buckets() const { return this->nr_buckets; }
+	int get_nr_nodes() const { return this->nr_nodes; }
+	Layout get_layout() const { return this->layout; }
+
+	// Strides in number of values (e.g. for strided numpy views)
+	std::size_t get_stride_bucket() const { return this->stride_bucket; }
+	std::size_t get_stride_from() const { return this->stride_from; }
+	std::size_t get_stride_to() const { return this->stride_to; }
+	bool empty() const { return this->nr_buckets == 0 || this->nr_nodes == 0; }
+	bool is_external() const { return this->external_owner != nullptr; }
+	bool is_compressed() const { return this->layout == COMPRESSED; }
+
+	const double* data() const { return this->base; }
+	double* data() { return this->base; }
+
+	// Number of stored values (nr_buckets*nr_nodes*nr_nodes if dense)
+	std::size_t size() const;
+
+	// Memory of the values and the arc runs in bytes
+	std::size_t memory_size() const { return this->size() * sizeof(double) + this->arc_runs.size() * sizeof(ArcRun); }
+
+	// Reorder the buffer into a different layout (O(nr_buckets*nr_nodes^2), not for the hot path)
+	void set_layout(Layout new_layout);
+
+	// Conversion to the nested form [bucket][from][to] (python interface)
+	std::vector<std::vector<std::vector<double>>> to_nested() const;
+
+	// Load slice [bucket] as matrix [from][to]
+	std::vector<std::vector<double>> slice(int bucket) const;
+};
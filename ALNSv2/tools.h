@@ -7,38 +7,61 @@ Templated functions must be defined directly in a header file! (otherwise linker
 #include <algorithm>
 #include <vector>
 #include <tuple>
-
-// Define random macros based on http://www.cse.yorku.ca/~oz/marsaglia-rng.html
-#define znew (z=36969*(z&65535)+(z>>16))
-#define wnew (w=18000*(w&65535)+(w>>16))
-#define MWC ((znew<<16)+wnew )
-#define SHR3 (jsr^=(jsr<<17), jsr^=(jsr>>13), jsr^=(jsr<<5))
-#define CONG (jcong=69069*jcong+1234567)
-#define FIB ((b=a+b),(a=b-a))
-#define KISS ((MWC^CONG)+SHR3)
-#define LFIB4 (c++,t[c]=t[c]+t[UC(c+58)]+t[UC(c+119)]+t[UC(c+178)])
-#define SWB (c++,bro=(x<y),t[c]=(x=t[UC(c+34)])-(y=t[UC(c+19)]+bro))
-#define UNI (KISS*2.328306e-10) //uniform 0-1
-#define VNI ((long) KISS)*4.656613e-10 // uniform -1 to 1
-#define UC (unsigned char) /*a cast operation*/
-
-typedef unsigned long UL;
-/* Global static variables: */
-static UL z = 362436069, w = 521288629, jsr = 123456789, jcong = 380116160;
-static UL a = 224466889, b = 7584631, t[256];
-/* Use random seeds to reset z,w,jsr,jcong,a,b, and the table
-t[256]*/
-static UL x = 0, y = 0, bro; static unsigned char c = 0;
+#include <cstdint>
 
 namespace tools {
-	// Build vector that contains a value range from min to max
-	std::vector<int> range(int max, int min = 0);
+	/**
+	Random number generator based on the KISS generator of Marsaglia
+	(http://www.cse.yorku.ca/~oz/marsaglia-rng.html)
+
+	Each solver owns one generator -> reproducible (seed) and thread safe.
+	Fulfills the UniformRandomBitGenerator interface and can therefore
+	also be used with the std distributions.
+	*/
+	class RandomGenerator {
+	private:
+		// KISS state (32 bit on every platform)
+		uint32_t z, w, jsr, jcong;
+
+	public:
+		typedef uint32_t result_type;
+
+		explicit RandomGenerator(uint32_t seed = 0) { this->seed(seed); };
+
+		// Reset the stream, identical seeds result in identical streams
+		void seed(uint32_t seed);
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT32_MAX; }
 
-	// Get random number between min and max
-	int rand_number(int max, int min = 0, bool fixed = true);
+		inline result_type operator()() {
+			this->z = 36969 * (this->z & 65535) + (this->z >> 16);
+			this->w = 18000 * (this->w & 65535) + (this->w >> 16);
+			uint32_t mwc = (this->z << 16) + this->w;
 
-	// Get random number normal distributed
-	int rand_number_normal(double mean, double std);
+			this->jcong = 69069 * this->jcong + 1234567;
+
+			this->jsr ^= (this->jsr << 17);
+			this->jsr ^= (this->jsr >> 13);
+			this->jsr ^= (this->jsr << 5);
+
+			return (mwc ^ this->jcong) + this->jsr;
+		}
+
+		// uniform 0-1
+		inline double uniform() {
+			return (*this)() * 2.328306e-10;
+		}
+
+		// Get random number between min and max
+		int rand_number(int max, int min = 0);
+
+		// Get random number normal distributed
+		int rand_number_normal(double mean, double std);
+	};
+
+	// Build vector that contains a value range from min to max
+	std::vector<int> range(int max, int min = 0);
 
 	/**
 	Replace the values of v1 from v2 at positions
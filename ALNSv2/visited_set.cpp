@@ -0,0 +1,117 @@
+/**
+This file contains the open addressing table of visited solution fingerprints
+*/
+#include "visited_set.h"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+/**
+@param initial_capacity:	Number of slots (rounded up to a power of 2)
+*/
+VisitedSet::VisitedSet(size_t initial_capacity) {
+	size_t capacity = 16;
+	while (capacity < initial_capacity) {
+		capacity <<= 1;
+	}
+	this->slots.resize(capacity);
+}
+
+/**
+Get the slot of the key or the first empty slot of its probe sequence
+*/
+size_t VisitedSet::find_slot(const Fingerprint &key) const {
+	size_t mask = this->slots.size() - 1;
+	size_t pos = size_t(key.lo) & mask; // the fingerprint is already uniformly distributed
+
+	while (this->slots[pos].time_stamp >= 0 && this->slots[pos].key != key) {
+		pos = (pos + 1) & mask;
+	}
+	return pos;
+}
+
+/**
+Double the capacity and reinsert all elements (keeps the load factor <= 0.5)
+*/
+void VisitedSet::grow() {
+	vector<Slot> old_slots(this->slots.size() * 2);
+	old_slots.swap(this->slots);
+
+	for (const Slot &slot : old_slots) {
+		if (slot.time_stamp >= 0) {
+			this->slots[this->find_slot(slot.key)] = slot;
+		}
+	}
+}
+
+bool VisitedSet::contains(const Fingerprint &key) const {
+	return this->slots[this->find_slot(key)].time_stamp >= 0;
+}
+
+bool VisitedSet::insert(const Fingerprint &key, int64_t time_stamp) {
+	size_t pos = this->find_slot(key);
+	if (this->slots[pos].time_stamp >= 0) {
+		return false;
+	}
+
+	this->slots[pos].key = key;
+	this->slots[pos].time_stamp = time_stamp;
+	this->nr_elements++;
+
+	if (2 * this->nr_elements > this->slots.size()) {
+		this->grow();
+	}
+	return true;
+}
+
+void VisitedSet::merge(const VisitedSet &other) {
+	for (const Slot &slot : other.slots) {
+		if (slot.time_stamp >= 0) {
+			size_t pos = this->find_slot(slot.key);
+
+			if (this->slots[pos].time_stamp < 0) {
+				this->insert(slot.key, slot.time_stamp);
+			}
+			else if (slot.time_stamp < this->slots[pos].time_stamp) {
+				this->slots[pos].time_stamp = slot.time_stamp;
+			}
+		}
+	}
+}
+
+/**
+Export for the python interface (a bounded amount of data)
+
+@param max_count:	Max number of returned time stamps
+*/
+vector<int64_t> VisitedSet::get_time_stamps(size_t max_count) const {
+	vector<int64_t> time_stamps;
+	time_stamps.reserve(this->nr_elements);
+
+	for (const Slot &slot : this->slots) {
+		if (slot.time_stamp >= 0) {
+			time_stamps.push_back(slot.time_stamp);
+		}
+	}
+	sort(time_stamps.begin(), time_stamps.end());
+
+	if (time_stamps.size() <= max_count) {
+		return time_stamps;
+	}
+
+	// evenly subsample (first and last visit are always included)
+	vector<int64_t> sampled(max_count);
+	for (size_t i = 0; i < max_count; i++) {
+		size_t pos = max_count > 1 ? i * (time_stamps.size() - 1) / (max_count - 1) : 0;
+		sampled[i] = time_stamps[pos];
+	}
+	return sampled;
+}
+
+void VisitedSet::clear() {
+	for (Slot &slot : this->slots) {
+		slot.time_stamp = -1;
+	}
+	this->nr_elements = 0;
+}
@@ -0,0 +1,46 @@
+/**
+Set of visited solutions based on their fingerprint
+
+Open addressing hash table (linear probing, power of 2 capacity) that only stores
+the 128 bit fingerprint and the time stamp of the first visit of each solution.
+This replaces full copies of the solution representation (16 + 8 bytes per solution).
+
+Annotation:
+	Slots with a negative time stamp are empty. Time stamps are epoch based and never negative.
+*/
+#pragma once
+#include "fingerprint.h"
+#include <vector>
+#include <cstddef>
+
+class VisitedSet {
+private:
+	struct Slot {
+		Fingerprint key;
+		std::int64_t time_stamp = -1; // -1 -> empty
+	};
+
+	std::vector<Slot> slots;
+	std::size_t nr_elements = 0;
+
+	std::size_t find_slot(const Fingerprint &key) const;
+	void grow();
+
+public:
+	explicit VisitedSet(std::size_t initial_capacity = 1024);
+
+	bool contains(const Fingerprint &key) const;
+
+	// Insert if not yet visited. Returns true if the solution is new.
+	bool insert(const Fingerprint &key, std::int64_t time_stamp);
+
+	// Add all solutions of another set (first visit wins)
+	void merge(const VisitedSet &other);
+
+	// Sorted time stamps of the first visits (evenly subsampled to [max_count] entries)
+	std::vector<std::int64_t> get_time_stamps(std::size_t max_count) const;
+
+	std::size_t size() const { return this->nr_elements; }
+	bool empty() const { return this->nr_elements == 0; }
+	void clear();
+};